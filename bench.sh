@@ -0,0 +1,68 @@
+#!/bin/bash
+
+# Path Finder - Benchmark Script
+# Builds the engine benchmarks with optimizations and runs the PathFinder
+# suite. Arguments are passed through, e.g.:
+#   ./bench.sh --sizes 1k,10k --graphs grid --out results.json
+# Set BENCH=containers to run the CustomStack/CustomQueue benchmark instead,
+# BENCH=names for city name resolution, BENCH=allpairs for the distance
+# matrix against repeated Dijkstra (arguments: cities,... kinds,... threads),
+# BENCH=components for connected components on 1-32 threads (arguments:
+# routes,... kinds,... threads,...), BENCH=reorder for traversal speed
+# before and after renumbering cities, or BENCH=compressed for packed route
+# lists against plain ones (both with arguments: routes,... kinds,...).
+
+set -e
+cd "$(dirname "$0")"
+
+BUILD_DIR="bench_build"
+mkdir -p "$BUILD_DIR"
+ENGINE_SOURCES=$(ls cpp_src/src/*.cpp | grep -v main.cpp)
+CXXFLAGS="-std=c++17 -O2 -DNDEBUG -pthread -Icpp_src/include"
+
+if [ "${BENCH}" = "containers" ]; then
+    echo "🔧 Building container benchmark..." >&2
+    g++ $CXXFLAGS cpp_src/bench/ContainerBench.cpp -o "$BUILD_DIR/container_bench"
+    exec "$BUILD_DIR/container_bench" "$@"
+fi
+
+if [ "${BENCH}" = "names" ]; then
+    echo "🔧 Building name resolution benchmark..." >&2
+    g++ $CXXFLAGS cpp_src/bench/NameBench.cpp $ENGINE_SOURCES -o "$BUILD_DIR/name_bench"
+    exec "$BUILD_DIR/name_bench" "$@"
+fi
+
+if [ "${BENCH}" = "allpairs" ]; then
+    echo "🔧 Building all-pairs benchmark..." >&2
+    g++ $CXXFLAGS cpp_src/bench/AllPairsBench.cpp cpp_src/bench/GraphGenerators.cpp \
+        $ENGINE_SOURCES -o "$BUILD_DIR/allpairs_bench"
+    exec "$BUILD_DIR/allpairs_bench" "$@"
+fi
+
+if [ "${BENCH}" = "components" ]; then
+    echo "🔧 Building connected components benchmark..." >&2
+    g++ $CXXFLAGS cpp_src/bench/ComponentsBench.cpp cpp_src/bench/GraphGenerators.cpp \
+        $ENGINE_SOURCES -o "$BUILD_DIR/components_bench"
+    exec "$BUILD_DIR/components_bench" "$@"
+fi
+
+if [ "${BENCH}" = "reorder" ]; then
+    echo "🔧 Building reordering benchmark..." >&2
+    g++ $CXXFLAGS cpp_src/bench/ReorderBench.cpp cpp_src/bench/GraphGenerators.cpp \
+        $ENGINE_SOURCES -o "$BUILD_DIR/reorder_bench"
+    exec "$BUILD_DIR/reorder_bench" "$@"
+fi
+
+if [ "${BENCH}" = "compressed" ]; then
+    echo "🔧 Building compressed adjacency benchmark..." >&2
+    g++ $CXXFLAGS cpp_src/bench/CompressionBench.cpp cpp_src/bench/GraphGenerators.cpp \
+        $ENGINE_SOURCES -o "$BUILD_DIR/compression_bench"
+    exec "$BUILD_DIR/compression_bench" "$@"
+fi
+
+echo "🔧 Building PathFinder benchmark..." >&2
+g++ $CXXFLAGS cpp_src/bench/PathFinderBench.cpp cpp_src/bench/GraphGenerators.cpp \
+    $ENGINE_SOURCES -o "$BUILD_DIR/pathfinder_bench"
+
+echo "🚀 Running benchmark" >&2
+exec "$BUILD_DIR/pathfinder_bench" "$@"
@@ -0,0 +1,135 @@
+// Dense all-pairs distances (AllPairs, blocked Floyd-Warshall) against
+// repeated Dijkstra on the same regional sub-networks: one full
+// ShortestPathTree per source, and point-to-point ShortestPath::find
+// timed on a sample of pairs and scaled to all of them. Run through
+// bench.sh (BENCH=allpairs) or build from the repository root:
+//
+//   g++ -std=c++17 -O2 -pthread -Icpp_src/include -o allpairs_bench
+//       cpp_src/bench/AllPairsBench.cpp cpp_src/bench/GraphGenerators.cpp
+//       $(ls cpp_src/src/*.cpp | grep -v main.cpp)
+//
+//   ./allpairs_bench [cities,...] [graph kinds,...] [threads]
+//
+// Defaults: 500,1000,2000,5000 cities on grid,geometric,scalefree, one
+// thread per hardware thread. Each sub-network is the BFS neighbourhood of
+// one city in a generated network about three times its size.
+#include "AllPairs.h"
+#include "GraphGenerators.h"
+#include "ShortestPath.h"
+#include "ShortestPathTree.h"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <sstream>
+
+namespace {
+
+using Clock = chrono::steady_clock;
+
+double elapsed(Clock::time_point since) {
+    return chrono::duration<double>(Clock::now() - since).count();
+}
+
+vector<string> splitList(const string& s) {
+    vector<string> items;
+    stringstream ss(s);
+    string item;
+    while (getline(ss, item, ',')) {
+        if (!item.empty()) items.push_back(item);
+    }
+    return items;
+}
+
+// The routes among the first `cities` cities reached by BFS from city 0
+void regionOf(const GeneratedGraph& gen, size_t cities, Graph& region) {
+    vector<vector<int>> adj(gen.cities.size());
+    for (size_t i = 0; i < gen.routeCount(); ++i) {
+        adj[gen.source[i]].push_back(gen.target[i]);
+        adj[gen.target[i]].push_back(gen.source[i]);
+    }
+    vector<int> order = {0};
+    vector<char> inRegion(gen.cities.size(), 0);
+    inRegion[0] = 1;
+    for (size_t head = 0; head < order.size() && order.size() < cities; ++head) {
+        for (int v : adj[order[head]]) {
+            if (!inRegion[v] && order.size() < cities) {
+                inRegion[v] = 1;
+                order.push_back(v);
+            }
+        }
+    }
+    for (size_t i = 0; i < gen.routeCount(); ++i) {
+        if (inRegion[gen.source[i]] && inRegion[gen.target[i]]) {
+            region.addEdge(gen.cities[gen.source[i]], gen.cities[gen.target[i]], gen.weight[i]);
+        }
+    }
+}
+
+void compare(const string& kind, size_t cities, ThreadPool& pool) {
+    GeneratedGraph gen;
+    if (!GraphGenerators::generate(kind, 3 * cities, 1, gen)) {
+        cerr << "allpairs_bench: unknown graph kind '" << kind << "'\n";
+        exit(2);
+    }
+    Graph region;
+    regionOf(gen, cities, region);
+    vector<string> names = region.getNodes();
+    size_t n = names.size();
+    cout << kind << ": " << n << " cities, " << region.getRouteCount() << " routes\n";
+
+    Clock::time_point t = Clock::now();
+    DistanceMatrixResult matrix = AllPairs::distances(region, {}, false, pool);
+    double matrixSeconds = elapsed(t);
+    cout << "  distance matrix:          " << matrixSeconds << " s (" << matrix.message << ")\n";
+
+    t = Clock::now();
+    DistanceMatrixResult withHops = AllPairs::distances(region, {}, true, pool);
+    cout << "  with next hops:           " << elapsed(t) << " s\n";
+
+    // Spot-check the matrix against the trees while timing them
+    t = Clock::now();
+    size_t mismatches = 0;
+    mt19937 rng(7);
+    for (size_t i = 0; i < n; ++i) {
+        ShortestPathTree tree(region, region.findCity(matrix.cities[i]));
+        size_t j = rng() % n;
+        ShortestPathResult r = tree.query(region, region.findCity(matrix.cities[j]));
+        if ((r.found ? r.distance : -1) != matrix.distances[i * n + j]) mismatches++;
+    }
+    double treeSeconds = elapsed(t);
+    cout << "  Dijkstra tree per source: " << treeSeconds << " s (" << treeSeconds / matrixSeconds
+         << "x the matrix, one thread)\n";
+
+    size_t samples = min<size_t>(2000, n * n);
+    t = Clock::now();
+    for (size_t s = 0; s < samples; ++s) {
+        ShortestPath::find(region, names[rng() % n], names[rng() % n]);
+    }
+    double pairSeconds = elapsed(t) / samples * n * n;
+    cout << "  Dijkstra per pair:        " << pairSeconds << " s (scaled from " << samples << " pairs, "
+         << pairSeconds / matrixSeconds << "x the matrix)\n";
+
+    if (mismatches > 0) cout << "  MISMATCHES: " << mismatches << "\n";
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    vector<string> sizes = splitList(argc > 1 ? argv[1] : "500,1000,2000,5000");
+    vector<string> kinds = splitList(argc > 2 ? argv[2] : "grid,geometric,scalefree");
+    ThreadPool pool(argc > 3 ? atoi(argv[3]) : 0);
+
+    cout << "AllPairs kernel: " << AllPairs::kernelName() << ", " << pool.size() << " pool threads\n";
+    for (const string& kind : kinds) {
+        for (const string& size : sizes) {
+            size_t cities = strtoul(size.c_str(), nullptr, 10);
+            if (cities < 2 || cities > (size_t)AllPairs::MAX_CITIES) {
+                cerr << "allpairs_bench: sizes are 2 to " << AllPairs::MAX_CITIES << " cities\n";
+                return 2;
+            }
+            compare(kind, cities, pool);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,127 @@
+// Connected components (ConnectedComponents, parallel Afforest) on pools of
+// 1 to 32 threads against a sequential BFS labelling of the same network.
+// Each network is run whole and fragmented (a seeded 40% of its routes
+// kept), which leaves many components. Run through bench.sh
+// (BENCH=components) or build from the repository root:
+//
+//   g++ -std=c++17 -O2 -pthread -Icpp_src/include -o components_bench
+//       cpp_src/bench/ComponentsBench.cpp cpp_src/bench/GraphGenerators.cpp
+//       $(ls cpp_src/src/*.cpp | grep -v main.cpp)
+//
+//   ./components_bench [routes,...] [graph kinds,...] [pool threads,...]
+//
+// Defaults: 1M routes on grid,geometric,scalefree, pools of
+// 1,2,4,8,16,32 threads. Times are the best of 3 runs.
+#include "ConnectedComponents.h"
+#include "GraphGenerators.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <sstream>
+
+namespace {
+
+using Clock = chrono::steady_clock;
+const int RUNS = 3;
+
+double elapsed(Clock::time_point since) {
+    return chrono::duration<double>(Clock::now() - since).count();
+}
+
+vector<string> splitList(const string& s) {
+    vector<string> items;
+    stringstream ss(s);
+    string item;
+    while (getline(ss, item, ',')) {
+        if (!item.empty()) items.push_back(item);
+    }
+    return items;
+}
+
+// Sizes of the components, largest first, by BFS from each unlabelled city
+vector<int32_t> bfsSizes(const Graph& g) {
+    int n = g.idCount();
+    vector<char> seen(n, 0);
+    vector<int> queue;
+    vector<int32_t> sizes;
+    for (int s = 0; s < n; ++s) {
+        if (seen[s] || !g.isCity(s)) continue;
+        seen[s] = 1;
+        queue.assign(1, s);
+        for (size_t head = 0; head < queue.size(); ++head) {
+            for (const Arc& arc : g.neighbors(queue[head])) {
+                if (!seen[arc.to]) {
+                    seen[arc.to] = 1;
+                    queue.push_back(arc.to);
+                }
+            }
+        }
+        sizes.push_back((int32_t)queue.size());
+    }
+    stable_sort(sizes.begin(), sizes.end(), greater<int32_t>());
+    return sizes;
+}
+
+void compare(const GeneratedGraph& gen, double keep, const vector<unsigned>& threads) {
+    Graph g;
+    vector<int> ids(gen.cities.size());
+    for (size_t i = 0; i < gen.cities.size(); ++i) ids[i] = g.internCity(gen.cities[i]);
+    vector<RouteRecord> records;
+    mt19937 rng(11);
+    for (size_t i = 0; i < gen.routeCount(); ++i) {
+        if (keep < 1 && rng() % 1000 >= keep * 1000) continue;
+        records.push_back({ids[gen.source[i]], ids[gen.target[i]], gen.weight[i]});
+    }
+    g.mergeRoutes(records);
+    cout << gen.kind << (keep < 1 ? " (fragmented)" : "") << ": " << g.getCityCount() << " cities, "
+         << g.getRouteCount() << " routes\n";
+
+    Clock::time_point t = Clock::now();
+    vector<int32_t> expected = bfsSizes(g);
+    double bfsSeconds = elapsed(t);
+    cout << "  sequential BFS:   " << bfsSeconds << " s, " << expected.size() << " components\n";
+
+    double oneThread = 0;
+    for (unsigned count : threads) {
+        ThreadPool pool(count);
+        double best = 1e30;
+        ComponentsResult res;
+        for (int run = 0; run < RUNS; ++run) {
+            t = Clock::now();
+            res = ConnectedComponents::label(g, pool);
+            best = min(best, elapsed(t));
+        }
+        if (oneThread == 0) oneThread = best;
+        cout << "  " << pool.size() << (pool.size() == 1 ? " thread:  " : " threads: ") << "     " << best
+             << " s (" << oneThread / best << "x the first pool, " << bfsSeconds / best << "x BFS)";
+        if (res.sizes != expected) cout << "  MISMATCH";
+        cout << "\n";
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    vector<string> sizes = splitList(argc > 1 ? argv[1] : "1000000");
+    vector<string> kinds = splitList(argc > 2 ? argv[2] : "grid,geometric,scalefree");
+    vector<unsigned> threads;
+    for (const string& count : splitList(argc > 3 ? argv[3] : "1,2,4,8,16,32")) {
+        threads.push_back((unsigned)max(1, atoi(count.c_str())));
+    }
+
+    cout << thread::hardware_concurrency() << " hardware threads\n";
+    for (const string& kind : kinds) {
+        for (const string& size : sizes) {
+            GeneratedGraph gen;
+            if (!GraphGenerators::generate(kind, strtoul(size.c_str(), nullptr, 10), 1, gen)) {
+                cerr << "components_bench: unknown graph kind '" << kind << "'\n";
+                return 2;
+            }
+            compare(gen, 1.0, threads);
+            compare(gen, 0.4, threads);
+        }
+    }
+    return 0;
+}
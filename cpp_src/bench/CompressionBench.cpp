@@ -0,0 +1,150 @@
+// Memory and traversal speed of compressed route lists (Graph::compress,
+// CompressedAdjacency) against the plain vector-per-city layout on large
+// generated networks, as generated and after reverse Cuthill-McKee
+// renumbering (smaller gaps pack tighter). Run through bench.sh
+// (BENCH=compressed) or build from the repository root:
+//
+//   g++ -std=c++17 -O2 -pthread -Icpp_src/include -o compression_bench
+//       cpp_src/bench/CompressionBench.cpp cpp_src/bench/GraphGenerators.cpp
+//       $(ls cpp_src/src/*.cpp | grep -v main.cpp)
+//
+//   ./compression_bench [routes,...] [graph kinds,...]
+//
+// Defaults: 1M and 4M routes on grid,geometric,scalefree,ethiopia. Times
+// are the best of 3 runs from the same 8 sources; memory counts the route
+// lists only (names are shared by both layouts).
+#include "CitiesWithin.h"
+#include "ConnectedComponents.h"
+#include "GraphGenerators.h"
+#include "GraphOrder.h"
+#include "QueryWorkspace.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+
+namespace {
+
+using Clock = chrono::steady_clock;
+const int RUNS = 3;
+const int SOURCES = 8;
+
+double elapsed(Clock::time_point since) {
+    return chrono::duration<double>(Clock::now() - since).count();
+}
+
+vector<string> splitList(const string& s) {
+    vector<string> items;
+    stringstream ss(s);
+    string item;
+    while (getline(ss, item, ',')) {
+        if (!item.empty()) items.push_back(item);
+    }
+    return items;
+}
+
+template <typename F>
+double best(F run) {
+    double fastest = 1e30;
+    for (int i = 0; i < RUNS; ++i) {
+        Clock::time_point t = Clock::now();
+        run();
+        fastest = min(fastest, elapsed(t));
+    }
+    return fastest;
+}
+
+size_t bfs(const Graph& g, int source) {
+    QueryWorkspace& ws = QueryWorkspace::acquire(g.idCount());
+    vector<int>& queue = ws.frontier;
+    queue.assign(1, source);
+    ws.visit(source);
+    for (size_t head = 0; head < queue.size(); ++head) {
+        for (const Arc& arc : g.neighbors(queue[head])) {
+            if (!ws.visited(arc.to)) {
+                ws.visit(arc.to);
+                queue.push_back(arc.to);
+            }
+        }
+    }
+    return queue.size();
+}
+
+struct Timings {
+    double bfs, dijkstra, components;
+};
+
+Timings timeAll(Graph& g, const vector<string>& sources, ThreadPool& pool) {
+    size_t reached = 0;
+    Timings t;
+    t.bfs = best([&] {
+        for (const string& s : sources) reached += bfs(g, g.findCity(s));
+    }) / sources.size();
+    t.dijkstra = best([&] {
+        for (const string& s : sources) reached += CitiesWithin::byDistance(g, s, INT_MAX).cities.size();
+    }) / sources.size();
+    t.components = best([&] { reached += ConnectedComponents::label(g, pool).sizes.size(); });
+    if (reached == 0) cout << "  (nothing reached)\n";
+    return t;
+}
+
+void compare(Graph& g, const string& label, const vector<string>& sources, ThreadPool& pool) {
+    Timings plain = timeAll(g, sources, pool);
+    Clock::time_point t = Clock::now();
+    pair<size_t, size_t> bytes = g.compress();
+    double packSeconds = elapsed(t);
+    Timings packed = timeAll(g, sources, pool);
+    double routes = (double)g.getRouteCount();
+
+    cout << "  " << label << ": packed in " << packSeconds << " s\n" << fixed << setprecision(2)
+         << "    memory      " << setw(8) << bytes.first / 1048576.0 << " MB -> " << setw(8)
+         << bytes.second / 1048576.0 << " MB  (" << bytes.first / routes << " -> " << bytes.second / routes
+         << " bytes per route, " << (double)bytes.first / bytes.second << "x)\n"
+         << setprecision(4) << "    BFS         " << setw(8) << plain.bfs << " s  -> " << setw(8) << packed.bfs
+         << " s   (" << packed.bfs / plain.bfs << "x the time)\n"
+         << "    Dijkstra    " << setw(8) << plain.dijkstra << " s  -> " << setw(8) << packed.dijkstra << " s   ("
+         << packed.dijkstra / plain.dijkstra << "x)\n"
+         << "    components  " << setw(8) << plain.components << " s  -> " << setw(8) << packed.components
+         << " s   (" << packed.components / plain.components << "x)\n";
+    cout.unsetf(ios::fixed);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    vector<string> sizes = splitList(argc > 1 ? argv[1] : "1000000,4000000");
+    vector<string> kinds = splitList(argc > 2 ? argv[2] : "grid,geometric,scalefree,ethiopia");
+    ThreadPool pool(1);
+
+    cout << "CompressedAdjacency decoder: " << CompressedAdjacency::decoderName() << "\n";
+    for (const string& kind : kinds) {
+        for (const string& size : sizes) {
+            GeneratedGraph gen;
+            if (!GraphGenerators::generate(kind, strtoul(size.c_str(), nullptr, 10), 1, gen)) {
+                cerr << "compression_bench: unknown graph kind '" << kind << "'\n";
+                return 2;
+            }
+            Graph g;
+            vector<RouteRecord> records(gen.routeCount());
+            vector<int> ids(gen.cities.size());
+            for (size_t i = 0; i < gen.cities.size(); ++i) ids[i] = g.internCity(gen.cities[i]);
+            for (size_t i = 0; i < gen.routeCount(); ++i) {
+                records[i] = {ids[gen.source[i]], ids[gen.target[i]], gen.weight[i]};
+            }
+            g.mergeRoutes(records);
+
+            mt19937 rng(5);
+            vector<string> sources;
+            for (int s = 0; s < SOURCES; ++s) sources.push_back(gen.cities[gen.source[rng() % gen.routeCount()]]);
+
+            cout << kind << ": " << g.getCityCount() << " cities, " << g.getRouteCount() << " routes\n";
+            compare(g, "as generated", sources, pool);
+            g.renumber(GraphOrder::reverseCuthillMcKee(g));
+            compare(g, "rcm order", sources, pool);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,165 @@
+// BFS / DFS throughput of CustomQueue and CustomStack against the linked-list
+// versions they replaced. Build and run from the repository root:
+//
+//   g++ -std=c++17 -O2 -Icpp_src/include cpp_src/bench/ContainerBench.cpp -o container_bench
+//   ./container_bench [cities] [routes-per-city] [rounds]
+#include "DataStructures.h"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+
+namespace {
+
+// --- The previous node-per-push containers, kept here for comparison ---
+template <typename T>
+class LinkedStack {
+    struct Node { T data; Node* next; };
+    Node* topNode = nullptr;
+public:
+    void push(T val) { topNode = new Node{val, topNode}; }
+    void pop() {
+        if (topNode) {
+            Node* t = topNode;
+            topNode = topNode->next;
+            delete t;
+        }
+    }
+    T top() { return topNode->data; }
+    bool empty() { return topNode == nullptr; }
+    ~LinkedStack() { while (!empty()) pop(); }
+};
+
+template <typename T>
+class LinkedQueue {
+    struct Node { T data; Node* next; };
+    Node *frontNode = nullptr, *rearNode = nullptr;
+public:
+    void enqueue(T val) {
+        Node* newNode = new Node{val, nullptr};
+        if (!rearNode) { frontNode = rearNode = newNode; return; }
+        rearNode->next = newNode; rearNode = newNode;
+    }
+    void dequeue() {
+        if (frontNode) {
+            Node* t = frontNode;
+            frontNode = frontNode->next;
+            if (!frontNode) rearNode = nullptr;
+            delete t;
+        }
+    }
+    T front() { return frontNode->data; }
+    bool empty() { return frontNode == nullptr; }
+    ~LinkedQueue() { while (!empty()) dequeue(); }
+};
+
+using Adjacency = vector<vector<int>>;
+
+Adjacency randomGraph(int cities, int degree) {
+    mt19937 rng(42);
+    Adjacency adj(cities);
+    for (int u = 0; u < cities; ++u) {
+        for (int i = 0; i < degree; ++i) {
+            int v = rng() % cities;
+            adj[u].push_back(v);
+            adj[v].push_back(u);
+        }
+    }
+    return adj;
+}
+
+// Payload is either the city id or its name, as in the string-keyed planners
+template <typename T>
+T payload(int id, const vector<string>& names);
+template <>
+int payload<int>(int id, const vector<string>&) { return id; }
+template <>
+string payload<string>(int id, const vector<string>& names) { return names[id]; }
+
+int idOf(int v, const vector<string>&) { return v; }
+int idOf(const string& v, const vector<string>&) { return atoi(v.c_str() + 1); }
+
+template <typename Queue, typename T>
+size_t bfs(const Adjacency& adj, const vector<string>& names, vector<char>& seen, Queue& q) {
+    fill(seen.begin(), seen.end(), 0);
+    size_t visited = 0;
+    q.enqueue(payload<T>(0, names));
+    seen[0] = 1;
+    while (!q.empty()) {
+        int u = idOf(q.front(), names);
+        q.dequeue();
+        visited++;
+        for (int v : adj[u]) {
+            if (!seen[v]) {
+                seen[v] = 1;
+                q.enqueue(payload<T>(v, names));
+            }
+        }
+    }
+    return visited;
+}
+
+template <typename Stack, typename T>
+size_t dfs(const Adjacency& adj, const vector<string>& names, vector<char>& seen, Stack& s) {
+    fill(seen.begin(), seen.end(), 0);
+    size_t visited = 0;
+    s.push(payload<T>(0, names));
+    while (!s.empty()) {
+        int u = idOf(s.top(), names);
+        s.pop();
+        if (seen[u]) continue;
+        seen[u] = 1;
+        visited++;
+        for (int v : adj[u]) {
+            if (!seen[v]) s.push(payload<T>(v, names));
+        }
+    }
+    return visited;
+}
+
+// Runs `traverse` rounds times and prints visited cities per second
+template <typename F>
+void report(const char* label, int rounds, F traverse) {
+    auto started = chrono::steady_clock::now();
+    size_t visited = 0;
+    for (int r = 0; r < rounds; ++r) visited += traverse();
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - started).count();
+    cout << "  " << label << ": " << (long long)(visited / seconds) << " cities/s\n";
+}
+
+template <typename T>
+void compare(const char* title, const Adjacency& adj, const vector<string>& names, int rounds) {
+    vector<char> seen(adj.size());
+    cout << title << "\n";
+
+    report("BFS LinkedQueue ", rounds, [&] {
+        LinkedQueue<T> q; // fresh per traversal, as the algorithms used it
+        return bfs<LinkedQueue<T>, T>(adj, names, seen, q);
+    });
+    CustomQueue<T> queue; // reused: its chunks stay allocated between rounds
+    report("BFS CustomQueue ", rounds, [&] { return bfs<CustomQueue<T>, T>(adj, names, seen, queue); });
+
+    report("DFS LinkedStack ", rounds, [&] {
+        LinkedStack<T> s;
+        return dfs<LinkedStack<T>, T>(adj, names, seen, s);
+    });
+    CustomStack<T> stack;
+    report("DFS CustomStack ", rounds, [&] { return dfs<CustomStack<T>, T>(adj, names, seen, stack); });
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int cities = argc > 1 ? atoi(argv[1]) : 200000;
+    int degree = argc > 2 ? atoi(argv[2]) : 3;
+    int rounds = argc > 3 ? atoi(argv[3]) : 10;
+
+    Adjacency adj = randomGraph(cities, degree);
+    vector<string> names(cities);
+    for (int i = 0; i < cities; ++i) names[i] = "C" + to_string(i);
+
+    cout << cities << " cities, " << (size_t)cities * degree << " routes, " << rounds << " rounds\n";
+    compare<int>("int payload", adj, names, rounds);
+    compare<string>("string payload", adj, names, rounds);
+    return 0;
+}
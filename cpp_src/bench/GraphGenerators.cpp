@@ -0,0 +1,161 @@
+#include "GraphGenerators.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+namespace {
+
+void addRoute(GeneratedGraph& g, int a, int b, int w) {
+    g.source.push_back(a);
+    g.target.push_back(b);
+    g.weight.push_back(w);
+}
+
+} // namespace
+
+GeneratedGraph GraphGenerators::grid(size_t routes, uint32_t seed) {
+    GeneratedGraph g;
+    g.kind = "grid";
+    mt19937 rng(seed);
+    uniform_int_distribution<int> segment(10, 100);
+
+    // side * (side - 1) * 2 routes, stopping once the target is reached
+    size_t side = 2;
+    while (2 * side * (side - 1) < routes) side++;
+
+    g.cities.reserve(side * side);
+    for (size_t r = 0; r < side; ++r) {
+        for (size_t c = 0; c < side; ++c) {
+            g.cities.push_back("G" + to_string(r) + "_" + to_string(c));
+        }
+    }
+
+    g.source.reserve(routes);
+    g.target.reserve(routes);
+    g.weight.reserve(routes);
+    for (size_t r = 0; r < side && g.routeCount() < routes; ++r) {
+        for (size_t c = 0; c < side && g.routeCount() < routes; ++c) {
+            int id = r * side + c;
+            if (c + 1 < side) addRoute(g, id, id + 1, segment(rng));
+            if (r + 1 < side && g.routeCount() < routes) addRoute(g, id, id + side, segment(rng));
+        }
+    }
+    return g;
+}
+
+GeneratedGraph GraphGenerators::geometric(size_t routes, uint32_t seed) {
+    GeneratedGraph g;
+    g.kind = "geometric";
+    mt19937 rng(seed);
+    uniform_real_distribution<double> coord(0.0, 1.0);
+
+    size_t n = routes / 3 + 2;
+    double radius = sqrt(6.0 / (M_PI * n));
+    vector<double> x(n), y(n);
+    g.cities.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        x[i] = coord(rng);
+        y[i] = coord(rng);
+        g.cities.push_back("P" + to_string(i));
+    }
+
+    // Bucket cities into radius-sized cells so only adjacent cells are compared
+    int cells = max(1, (int)(1.0 / radius));
+    vector<vector<int>> bucket(cells * cells);
+    auto cellOf = [&](double v) { return min(cells - 1, (int)(v * cells)); };
+    for (size_t i = 0; i < n; ++i) bucket[cellOf(y[i]) * cells + cellOf(x[i])].push_back(i);
+
+    for (size_t i = 0; i < n && g.routeCount() < routes; ++i) {
+        int cx = cellOf(x[i]), cy = cellOf(y[i]);
+        for (int dy = -1; dy <= 1; ++dy) {
+            for (int dx = -1; dx <= 1; ++dx) {
+                int nx = cx + dx, ny = cy + dy;
+                if (nx < 0 || ny < 0 || nx >= cells || ny >= cells) continue;
+                for (int j : bucket[ny * cells + nx]) {
+                    if ((size_t)j <= i || g.routeCount() >= routes) continue;
+                    double d = hypot(x[i] - x[j], y[i] - y[j]);
+                    if (d <= radius) addRoute(g, i, j, 1 + (int)(d * 10000));
+                }
+            }
+        }
+    }
+    return g;
+}
+
+GeneratedGraph GraphGenerators::scaleFree(size_t routes, uint32_t seed) {
+    GeneratedGraph g;
+    g.kind = "scalefree";
+    mt19937 rng(seed);
+    uniform_int_distribution<int> flight(50, 2000);
+
+    // Every route endpoint is listed once, so a uniform pick from this list
+    // chooses a city with probability proportional to its degree
+    vector<int> endpoints;
+    endpoints.reserve(2 * routes + 6);
+
+    for (int i = 0; i < 3; ++i) g.cities.push_back("H" + to_string(i));
+    addRoute(g, 0, 1, flight(rng));
+    addRoute(g, 1, 2, flight(rng));
+    addRoute(g, 2, 0, flight(rng));
+    endpoints.insert(endpoints.end(), {0, 1, 1, 2, 2, 0});
+
+    while (g.routeCount() < routes) {
+        int city = g.cities.size();
+        g.cities.push_back("H" + to_string(city));
+
+        int first = -1;
+        for (int k = 0; k < 2 && g.routeCount() < routes; ++k) {
+            int hub = endpoints[rng() % endpoints.size()];
+            if (hub == first) continue;
+            first = hub;
+            addRoute(g, city, hub, flight(rng));
+            endpoints.push_back(city);
+            endpoints.push_back(hub);
+        }
+    }
+    return g;
+}
+
+GeneratedGraph GraphGenerators::ethiopia(size_t routes, uint32_t seed) {
+    GeneratedGraph g;
+    g.kind = "ethiopia";
+    mt19937 rng(seed);
+    uniform_real_distribution<double> jitter(0.9, 1.1);
+    uniform_int_distribution<int> longHaul(300, 900);
+
+    // Sample data loaded by main.cpp
+    const vector<string> sampleCities = {"Addis Ababa", "Adama", "Dire Dawa", "Bahir Dar", "Gondar", "Hawassa"};
+    const int sampleRoutes[][3] = {{0, 1, 100}, {1, 2, 350}, {0, 3, 500}, {3, 4, 180}, {1, 5, 200}};
+
+    int regions = 0;
+    while (g.routeCount() < routes) {
+        int base = g.cities.size();
+        for (const auto& city : sampleCities) {
+            g.cities.push_back(regions == 0 ? city : city + " " + to_string(regions));
+        }
+        for (const auto& r : sampleRoutes) {
+            if (g.routeCount() >= routes) break;
+            addRoute(g, base + r[0], base + r[1], (int)lround(r[2] * jitter(rng)));
+        }
+        // Each new region's capital links to an earlier region's Gondar
+        if (regions > 0 && g.routeCount() < routes) {
+            int earlier = rng() % regions;
+            addRoute(g, base, earlier * (int)sampleCities.size() + 4, longHaul(rng));
+        }
+        regions++;
+    }
+    return g;
+}
+
+bool GraphGenerators::generate(const string& kind, size_t routes, uint32_t seed, GeneratedGraph& out) {
+    if (kind == "grid") out = grid(routes, seed);
+    else if (kind == "geometric") out = geometric(routes, seed);
+    else if (kind == "scalefree") out = scaleFree(routes, seed);
+    else if (kind == "ethiopia") out = ethiopia(routes, seed);
+    else return false;
+    return true;
+}
+
+vector<string> GraphGenerators::kinds() {
+    return {"grid", "geometric", "scalefree", "ethiopia"};
+}
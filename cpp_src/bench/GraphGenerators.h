@@ -0,0 +1,42 @@
+#ifndef GRAPH_GENERATORS_H
+#define GRAPH_GENERATORS_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Synthetic route network in the columnar form PathFinder::addRoutesColumns
+// takes: source/target index into cities. The same kind, size and seed
+// always produce the same graph.
+struct GeneratedGraph {
+    string kind;
+    vector<string> cities;
+    vector<int32_t> source;
+    vector<int32_t> target;
+    vector<int32_t> weight;
+
+    size_t routeCount() const { return source.size(); }
+};
+
+class GraphGenerators {
+public:
+    // 2D road grid, 4-neighbour, short uniform segments
+    static GeneratedGraph grid(size_t routes, uint32_t seed);
+    // Cities scattered in a unit square, linked when closer than a radius
+    // chosen for ~6 routes per city; weight is the scaled distance
+    static GeneratedGraph geometric(size_t routes, uint32_t seed);
+    // Preferential attachment (Barabasi-Albert, 2 routes per new city):
+    // a few hubs with very high degree, like airline networks
+    static GeneratedGraph scaleFree(size_t routes, uint32_t seed);
+    // The sample network from main.cpp, replicated as regions joined by
+    // long-haul routes, with distances jittered by up to 10%
+    static GeneratedGraph ethiopia(size_t routes, uint32_t seed);
+
+    // kind is one of "grid", "geometric", "scalefree", "ethiopia"
+    static bool generate(const string& kind, size_t routes, uint32_t seed, GeneratedGraph& out);
+    static vector<string> kinds();
+};
+
+#endif // GRAPH_GENERATORS_H
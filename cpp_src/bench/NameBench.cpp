@@ -0,0 +1,113 @@
+/*
+ * Case-insensitive city name resolution: the previous toLower copy plus
+ * unordered_map<string, int> lookup against Graph::findCity (NameFold +
+ * NameTable). Run through bench.sh (BENCH=names) or build from the
+ * repository root:
+ *
+ *   g++ -std=c++17 -O2 -pthread -Icpp_src/include -o name_bench \
+ *       cpp_src/bench/NameBench.cpp $(find cpp_src/src -name '*.cpp' ! -name main.cpp)
+ *
+ *   ./name_bench [cities] [lookups]
+ */
+#include "Graph.h"
+#include "NameFold.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <unordered_map>
+
+namespace {
+
+// --- The previous key handling, kept here for comparison ---
+string toLower(string s) {
+    transform(s.begin(), s.end(), s.begin(), ::tolower);
+    return s;
+}
+
+// UTF-8 syllables of the Ethiopic block (no case) and Latin-1 letters
+const char* ETHIOPIC[] = {"አ", "ዲ", "ስ", "በ", "ባ", "ጎ", "ን", "ደ", "ር", "ሐ", "ዋ", "ሳ", "መ", "ቀ", "ሌ"};
+const char* LATIN1[] = {"É", "é", "Ü", "ü", "Ö", "ö", "Ç", "ç", "Ñ", "ñ"};
+
+vector<string> makeNames(const string& script, int count) {
+    mt19937 rng(7);
+    vector<string> names(count);
+    for (int i = 0; i < count; ++i) {
+        string& name = names[i];
+        int length = 6 + rng() % 14;
+        for (int k = 0; k < length; ++k) {
+            if (script == "ethiopic") {
+                name += ETHIOPIC[rng() % 15];
+            } else if (script == "latin1" && rng() % 4 == 0) {
+                name += LATIN1[rng() % 10];
+            } else {
+                name += (char)((k == 0 ? 'A' : 'a') + rng() % 26);
+            }
+        }
+        name += " " + to_string(i); // keeps names unique
+    }
+    return names;
+}
+
+// Uppercases ASCII letters only, as a user typing in caps would for these scripts
+string shout(string s) {
+    for (char& c : s) {
+        if (c >= 'a' && c <= 'z') c -= 32;
+    }
+    return s;
+}
+
+template <typename F>
+void report(const char* label, size_t lookups, F resolve) {
+    auto started = chrono::steady_clock::now();
+    long long found = 0;
+    for (size_t i = 0; i < lookups; ++i) found += resolve(i) >= 0;
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - started).count();
+    cout << "  " << label << ": " << (long long)(lookups / seconds) << " lookups/s"
+         << " (" << found << " found)\n";
+}
+
+void compare(const string& script, int cities, size_t lookups) {
+    vector<string> names = makeNames(script, cities);
+
+    unordered_map<string, int> lowered;
+    Graph g;
+    for (int i = 0; i < cities; ++i) {
+        lowered.emplace(toLower(names[i]), i);
+        g.internCity(names[i]);
+    }
+
+    // Half the queries as stored, half shouted; 1 in 8 unknown
+    mt19937 rng(11);
+    vector<string> queries(4096);
+    for (auto& q : queries) {
+        int id = rng() % cities;
+        q = rng() % 2 ? names[id] : shout(names[id]);
+        if (rng() % 8 == 0) q += "?";
+    }
+    size_t mask = queries.size() - 1;
+
+    cout << script << " names\n";
+    report("toLower + unordered_map", lookups, [&](size_t i) {
+        auto it = lowered.find(toLower(queries[i & mask]));
+        return it == lowered.end() ? -1 : it->second;
+    });
+    report("Graph::findCity        ", lookups, [&](size_t i) { return g.findCity(queries[i & mask]); });
+    report("NameFold::hash only    ", lookups, [&](size_t i) {
+        return (int)(NameFold::hash(queries[i & mask]) & 1);
+    });
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int cities = argc > 1 ? atoi(argv[1]) : 100000;
+    size_t lookups = argc > 2 ? atoll(argv[2]) : 5000000;
+
+    cout << cities << " cities, " << lookups << " lookups per run\n";
+    compare("ascii", cities, lookups);
+    compare("latin1", cities, lookups);
+    compare("ethiopic", cities, lookups);
+    return 0;
+}
@@ -0,0 +1,353 @@
+// Throughput and latency percentiles of every PathFinder operation on
+// reproducible synthetic networks, written as JSON for regression tracking.
+// Run through bench.sh at the repository root, or build directly:
+//
+//   g++ -std=c++17 -O2 -pthread -Icpp_src/include -o pathfinder_bench
+//       cpp_src/bench/PathFinderBench.cpp cpp_src/bench/GraphGenerators.cpp
+//       $(ls cpp_src/src/*.cpp | grep -v main.cpp)
+//
+//   ./pathfinder_bench [--graphs grid,geometric,scalefree,ethiopia]
+//                      [--sizes 1k,10k,100k,1M] [--seed 1] [--budget 2]
+//                      [--samples 1000] [--out results.json]
+//
+// Sizes are route counts (k and M suffixes accepted, up to 10M). Each
+// operation runs until it has --samples calls or has used --budget seconds,
+// whichever comes first, with at least one call.
+#include "GraphGenerators.h"
+#include "PathFinder.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <sstream>
+
+namespace {
+
+struct BenchOptions {
+    vector<string> graphs = GraphGenerators::kinds();
+    vector<size_t> sizes = {1000, 10000, 100000, 1000000};
+    uint32_t seed = 1;
+    double budget = 2.0;
+    size_t samples = 1000;
+    string out;
+};
+
+struct OpResult {
+    string graph;
+    size_t targetRoutes;
+    size_t cities;
+    size_t routes;
+    string operation;
+    string unit;             // what ops_per_second counts
+    size_t samples;
+    double seconds;
+    double opsPerSecond;
+    vector<double> latencyUs; // p50, p90, p99, max
+    string note;
+};
+
+using Clock = chrono::steady_clock;
+
+double elapsed(Clock::time_point since) {
+    return chrono::duration<double>(Clock::now() - since).count();
+}
+
+vector<double> percentiles(vector<double> us) {
+    sort(us.begin(), us.end());
+    auto at = [&](double q) { return us[(size_t)llround(q * (us.size() - 1))]; };
+    return {at(0.50), at(0.90), at(0.99), us.back()};
+}
+
+// Calls op(i) for i = 0, 1, ... within the sample and time budget
+OpResult measure(const string& operation, const BenchOptions& opt, function<void(size_t)> op) {
+    vector<double> latencies;
+    Clock::time_point started = Clock::now();
+    for (size_t i = 0; i < opt.samples; ++i) {
+        Clock::time_point t = Clock::now();
+        op(i);
+        latencies.push_back(elapsed(t) * 1e6);
+        if (elapsed(started) >= opt.budget) break;
+    }
+
+    OpResult r;
+    r.operation = operation;
+    r.unit = "calls";
+    r.samples = latencies.size();
+    r.seconds = elapsed(started);
+    r.opsPerSecond = r.samples / r.seconds;
+    r.latencyUs = percentiles(latencies);
+    return r;
+}
+
+// Up to `limit` cities around start in BFS order, over the generated routes
+vector<int> neighbourhood(const vector<vector<int>>& adj, int start, size_t limit) {
+    vector<int> found = {start};
+    vector<char> seen(adj.size(), 0);
+    seen[start] = 1;
+    for (size_t head = 0; head < found.size() && found.size() < limit; ++head) {
+        for (int v : adj[found[head]]) {
+            if (!seen[v] && found.size() < limit) {
+                seen[v] = 1;
+                found.push_back(v);
+            }
+        }
+    }
+    return found;
+}
+
+vector<OpResult> benchGraph(const GeneratedGraph& gen, size_t targetRoutes, const BenchOptions& opt) {
+    vector<OpResult> results;
+    mt19937 rng(opt.seed);
+
+    vector<vector<int>> adj(gen.cities.size());
+    for (size_t i = 0; i < gen.routeCount(); ++i) {
+        adj[gen.source[i]].push_back(gen.target[i]);
+        adj[gen.target[i]].push_back(gen.source[i]);
+    }
+    // Query endpoints are drawn from route endpoints, so they always exist
+    auto randomCity = [&]() {
+        size_t r = rng() % gen.routeCount();
+        return rng() % 2 ? gen.source[r] : gen.target[r];
+    };
+    auto nameOf = [&](int id) { return gen.cities[id]; };
+
+    PathFinder pf;
+
+    // --- bulk load: one call, throughput counted in routes ---
+    Clock::time_point t = Clock::now();
+    pf.addRoutesColumns(gen.cities, gen.source.data(), gen.target.data(), gen.weight.data(), gen.routeCount());
+    double loadSeconds = elapsed(t);
+    OpResult load;
+    load.operation = "bulk_load";
+    load.unit = "routes";
+    load.samples = 1;
+    load.seconds = loadSeconds;
+    load.opsPerSecond = gen.routeCount() / loadSeconds;
+    load.latencyUs = vector<double>(4, loadSeconds * 1e6);
+    results.push_back(load);
+    size_t liveCities = pf.getAllCities().size();
+
+    // --- queries ---
+    vector<pair<int, int>> pairs(opt.samples);
+    for (auto& p : pairs) p = {randomCity(), randomCity()};
+
+    results.push_back(measure("shortest_path", opt, [&](size_t i) {
+        pf.findShortestPath(nameOf(pairs[i].first), nameOf(pairs[i].second));
+    }));
+    results.back().note = "random sources; mostly builds a fresh shortest-path tree";
+
+    vector<int> hotSources = {randomCity(), randomCity(), randomCity(), randomCity()};
+    results.push_back(measure("shortest_path_cached", opt, [&](size_t i) {
+        pf.findShortestPath(nameOf(hotSources[i % hotSources.size()]), nameOf(pairs[i].second));
+    }));
+    results.back().note = "4 repeating sources; answered from cached trees";
+
+    results.push_back(measure("fewest_stops", opt, [&](size_t i) {
+        pf.findFewestStops(nameOf(pairs[i].first), nameOf(pairs[i].second));
+    }));
+
+    results.push_back(measure("reachable_cities", opt, [&](size_t i) {
+        pf.findReachableCities(nameOf(pairs[i].first));
+    }));
+
+    results.push_back(measure("connected_components", opt, [&](size_t) { pf.connectedComponents(); }));
+
+    // Longest simple path is exponential: measured on 12-city subnetworks
+    const size_t SUBNETWORK = 12;
+    vector<unique_ptr<PathFinder>> subnetworks;
+    vector<pair<string, string>> subEnds;
+    for (int k = 0; k < 8; ++k) {
+        vector<int> ball = neighbourhood(adj, randomCity(), SUBNETWORK);
+        vector<char> inBall(gen.cities.size(), 0);
+        for (int c : ball) inBall[c] = 1;
+        auto sub = make_unique<PathFinder>();
+        for (int c : ball) {
+            for (size_t i = 0; i < adj[c].size(); ++i) {
+                int d = adj[c][i];
+                if (inBall[d] && c < d) sub->addCity(nameOf(c), nameOf(d), 1 + (c ^ d) % 100);
+            }
+        }
+        subEnds.push_back({nameOf(ball.front()), nameOf(ball.back())});
+        subnetworks.push_back(move(sub));
+    }
+    results.push_back(measure("longest_path", opt, [&](size_t i) {
+        size_t k = i % subnetworks.size();
+        subnetworks[k]->findLongestPath(subEnds[k].first, subEnds[k].second);
+    }));
+    results.back().note = to_string(SUBNETWORK) + "-city BFS neighbourhoods";
+
+    // Tours over 6 nearby cities, so direct routes between them are likely
+    vector<vector<string>> tours;
+    for (int k = 0; k < 32; ++k) {
+        vector<string> tour;
+        for (int c : neighbourhood(adj, randomCity(), 6)) tour.push_back(nameOf(c));
+        tours.push_back(tour);
+    }
+    results.push_back(measure("multi_city_tour", opt, [&](size_t i) {
+        pf.planMultiCityTour(tours[i % tours.size()]);
+    }));
+    results.back().note = "6 cities from one BFS neighbourhood";
+
+    results.push_back(measure("cheapest_network", opt, [&](size_t) { pf.findCheapestNetwork(); }));
+
+    // --- mutations, with the shortest-path tree cache warm so repairs count ---
+    vector<pair<int, int>> fresh(opt.samples);
+    for (auto& p : fresh) p = {randomCity(), randomCity()};
+    for (int s : hotSources) pf.findShortestPath(nameOf(s), nameOf(s));
+
+    size_t added = 0;
+    results.push_back(measure("add_route", opt, [&](size_t i) {
+        pf.addCity(nameOf(fresh[i].first), nameOf(fresh[i].second), 1 + rng() % 1000);
+        added = i + 1;
+    }));
+    results.push_back(measure("update_route", opt, [&](size_t) {
+        size_t r = rng() % gen.routeCount();
+        pf.updateCity(nameOf(gen.source[r]), nameOf(gen.target[r]), 1 + rng() % 1000);
+    }));
+    results.push_back(measure("remove_route", opt, [&](size_t i) {
+        size_t k = i % added;
+        pf.removeCity(nameOf(fresh[k].first), nameOf(fresh[k].second));
+    }));
+    results.back().note = "removes the routes added by add_route";
+
+    for (auto& r : results) {
+        r.graph = gen.kind;
+        r.targetRoutes = targetRoutes;
+        r.cities = liveCities;
+        r.routes = gen.routeCount();
+    }
+    return results;
+}
+
+string jsonString(const string& s) {
+    string out = "\"";
+    for (char c : s) {
+        if (c == '"' || c == '\\') out += '\\';
+        out += c;
+    }
+    return out + "\"";
+}
+
+string toJson(const vector<OpResult>& results, const BenchOptions& opt) {
+    ostringstream o;
+    o << "{\n  \"benchmark\": \"pathfinder\",\n  \"version\": 1,\n";
+    o << "  \"seed\": " << opt.seed << ",\n  \"budget_seconds\": " << opt.budget << ",\n";
+    o << "  \"max_samples\": " << opt.samples << ",\n";
+#ifdef __VERSION__
+    o << "  \"compiler\": " << jsonString(__VERSION__) << ",\n";
+#endif
+    o << "  \"results\": [";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const OpResult& r = results[i];
+        o << (i ? ",\n" : "\n") << "    {\"graph\": " << jsonString(r.graph)
+          << ", \"target_routes\": " << r.targetRoutes << ", \"cities\": " << r.cities
+          << ", \"routes\": " << r.routes << ", \"operation\": " << jsonString(r.operation)
+          << ", \"samples\": " << r.samples << ", \"seconds\": " << r.seconds
+          << ", \"ops_per_second\": " << r.opsPerSecond << ", \"unit\": " << jsonString(r.unit)
+          << ", \"latency_us\": {\"p50\": " << r.latencyUs[0] << ", \"p90\": " << r.latencyUs[1]
+          << ", \"p99\": " << r.latencyUs[2] << ", \"max\": " << r.latencyUs[3] << "}";
+        if (!r.note.empty()) o << ", \"note\": " << jsonString(r.note);
+        o << "}";
+    }
+    o << "\n  ]\n}\n";
+    return o.str();
+}
+
+vector<string> splitList(const string& s) {
+    vector<string> items;
+    stringstream ss(s);
+    string item;
+    while (getline(ss, item, ',')) {
+        if (!item.empty()) items.push_back(item);
+    }
+    return items;
+}
+
+bool parseSize(const string& s, size_t& out) {
+    char* end = nullptr;
+    double value = strtod(s.c_str(), &end);
+    string suffix = end;
+    if (suffix == "k" || suffix == "K") value *= 1e3;
+    else if (suffix == "m" || suffix == "M") value *= 1e6;
+    else if (!suffix.empty()) return false;
+    if (value < 10 || value > 1e7) return false;
+    out = (size_t)value;
+    return true;
+}
+
+bool parseArgs(int argc, char** argv, BenchOptions& opt, string& error) {
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (i + 1 >= argc) {
+            error = "missing value for " + arg;
+            return false;
+        }
+        string value = argv[++i];
+        if (arg == "--graphs") {
+            opt.graphs = splitList(value);
+        } else if (arg == "--sizes") {
+            opt.sizes.clear();
+            for (const auto& s : splitList(value)) {
+                size_t n;
+                if (!parseSize(s, n)) {
+                    error = "bad size '" + s + "' (10 to 10M routes)";
+                    return false;
+                }
+                opt.sizes.push_back(n);
+            }
+        } else if (arg == "--seed") {
+            opt.seed = strtoul(value.c_str(), nullptr, 10);
+        } else if (arg == "--budget") {
+            opt.budget = strtod(value.c_str(), nullptr);
+        } else if (arg == "--samples") {
+            opt.samples = max<size_t>(1, strtoul(value.c_str(), nullptr, 10));
+        } else if (arg == "--out") {
+            opt.out = value;
+        } else {
+            error = "unknown option " + arg;
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    BenchOptions opt;
+    string error;
+    if (!parseArgs(argc, argv, opt, error)) {
+        cerr << "pathfinder_bench: " << error << "\n";
+        return 2;
+    }
+
+    vector<OpResult> all;
+    for (const auto& kind : opt.graphs) {
+        for (size_t size : opt.sizes) {
+            GeneratedGraph gen;
+            if (!GraphGenerators::generate(kind, size, opt.seed, gen)) {
+                cerr << "pathfinder_bench: unknown graph kind '" << kind << "'\n";
+                return 2;
+            }
+            cerr << kind << " " << gen.cities.size() << " cities, " << gen.routeCount() << " routes\n";
+            for (auto& r : benchGraph(gen, size, opt)) {
+                cerr << "  " << r.operation << ": " << (long long)r.opsPerSecond << " " << r.unit
+                     << "/s, p50 " << r.latencyUs[0] << " us, p99 " << r.latencyUs[2] << " us\n";
+                all.push_back(move(r));
+            }
+        }
+    }
+
+    string json = toJson(all, opt);
+    if (opt.out.empty()) {
+        cout << json;
+    } else {
+        ofstream(opt.out) << json;
+        cerr << "wrote " << opt.out << "\n";
+    }
+    return 0;
+}
@@ -0,0 +1,143 @@
+// Traversal speed before and after renumbering cities (GraphOrder) on
+// large generated networks. Cities are first numbered in a shuffled order,
+// as a network loaded from unsorted route files would be, then each order
+// is applied to a copy and the same traversals are timed again. Run
+// through bench.sh (BENCH=reorder) or build from the repository root:
+//
+//   g++ -std=c++17 -O2 -pthread -Icpp_src/include -o reorder_bench
+//       cpp_src/bench/ReorderBench.cpp cpp_src/bench/GraphGenerators.cpp
+//       $(ls cpp_src/src/*.cpp | grep -v main.cpp)
+//
+//   ./reorder_bench [routes,...] [graph kinds,...]
+//
+// Defaults: 1M and 4M routes on grid,geometric,scalefree. Times are the
+// best of 3 runs from the same 8 sources.
+#include "CitiesWithin.h"
+#include "ConnectedComponents.h"
+#include "GraphGenerators.h"
+#include "GraphOrder.h"
+#include "QueryWorkspace.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+
+namespace {
+
+using Clock = chrono::steady_clock;
+const int RUNS = 3;
+const int SOURCES = 8;
+
+double elapsed(Clock::time_point since) {
+    return chrono::duration<double>(Clock::now() - since).count();
+}
+
+vector<string> splitList(const string& s) {
+    vector<string> items;
+    stringstream ss(s);
+    string item;
+    while (getline(ss, item, ',')) {
+        if (!item.empty()) items.push_back(item);
+    }
+    return items;
+}
+
+template <typename F>
+double best(F run) {
+    double fastest = 1e30;
+    for (int i = 0; i < RUNS; ++i) {
+        Clock::time_point t = Clock::now();
+        run();
+        fastest = min(fastest, elapsed(t));
+    }
+    return fastest;
+}
+
+// Whole-component BFS by id, the inner loop of reachability and stops
+// searches without the name strings
+size_t bfs(const Graph& g, int source) {
+    QueryWorkspace& ws = QueryWorkspace::acquire(g.idCount());
+    vector<int>& queue = ws.frontier;
+    queue.assign(1, source);
+    ws.visit(source);
+    for (size_t head = 0; head < queue.size(); ++head) {
+        for (const Arc& arc : g.neighbors(queue[head])) {
+            if (!ws.visited(arc.to)) {
+                ws.visit(arc.to);
+                queue.push_back(arc.to);
+            }
+        }
+    }
+    return queue.size();
+}
+
+void report(const string& label, Graph& g, const vector<string>& sources, ThreadPool& pool) {
+    size_t reached = 0;
+    double bfsSeconds = best([&] {
+        for (const string& s : sources) reached += bfs(g, g.findCity(s));
+    });
+    double dijkstraSeconds = best([&] {
+        for (const string& s : sources) reached += CitiesWithin::byDistance(g, s, INT_MAX).cities.size();
+    });
+    double componentsSeconds = best([&] { reached += ConnectedComponents::label(g, pool).sizes.size(); });
+    cout << "  " << left << setw(9) << label << right << fixed << setprecision(1) << setw(10)
+         << GraphOrder::meanGap(g) << setprecision(4) << setw(11) << bfsSeconds / sources.size()
+         << setw(11) << dijkstraSeconds / sources.size() << setw(11) << componentsSeconds << "\n";
+    cout.unsetf(ios::fixed);
+    if (reached == 0) cout << "  (nothing reached)\n";
+}
+
+void compare(const string& kind, size_t routes, ThreadPool& pool) {
+    GeneratedGraph gen;
+    if (!GraphGenerators::generate(kind, routes, 1, gen)) {
+        cerr << "reorder_bench: unknown graph kind '" << kind << "'\n";
+        exit(2);
+    }
+
+    // First appearance in a shuffled order
+    vector<int> shuffled(gen.cities.size());
+    for (size_t i = 0; i < shuffled.size(); ++i) shuffled[i] = (int)i;
+    mt19937 rng(5);
+    shuffle(shuffled.begin(), shuffled.end(), rng);
+    Graph original;
+    vector<int> ids(gen.cities.size());
+    for (int c : shuffled) ids[c] = original.internCity(gen.cities[c]);
+    vector<RouteRecord> records(gen.routeCount());
+    for (size_t i = 0; i < gen.routeCount(); ++i) {
+        records[i] = {ids[gen.source[i]], ids[gen.target[i]], gen.weight[i]};
+    }
+    original.mergeRoutes(records);
+
+    vector<string> sources;
+    for (int s = 0; s < SOURCES; ++s) sources.push_back(gen.cities[gen.source[rng() % gen.routeCount()]]);
+
+    cout << kind << ": " << original.getCityCount() << " cities, " << original.getRouteCount() << " routes\n"
+         << "  order      mean gap   BFS (s)   Dijkstra  components\n";
+    report("shuffled", original, sources, pool);
+    for (const string& method : GraphOrder::methods()) {
+        Graph g = original;
+        vector<int> order;
+        Clock::time_point t = Clock::now();
+        GraphOrder::compute(g, method, order);
+        g.renumber(order);
+        double seconds = elapsed(t);
+        report(method, g, sources, pool);
+        cout << "            (ordered and renumbered in " << seconds << " s)\n";
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    vector<string> sizes = splitList(argc > 1 ? argv[1] : "1000000,4000000");
+    vector<string> kinds = splitList(argc > 2 ? argv[2] : "grid,geometric,scalefree");
+    ThreadPool pool(1);
+
+    for (const string& kind : kinds) {
+        for (const string& size : sizes) compare(kind, strtoul(size.c_str(), nullptr, 10), pool);
+    }
+    return 0;
+}
@@ -0,0 +1,41 @@
+#ifndef ALL_PAIRS_H
+#define ALL_PAIRS_H
+
+#include "Graph.h"
+#include "SearchStats.h"
+#include "ThreadPool.h"
+#include <string>
+#include <vector>
+
+// Distances between every pair of a set of cities, row-major in the order
+// of `cities`: entry i * n + j is from cities[i] to cities[j]
+struct DistanceMatrixResult {
+    bool found;
+    vector<string> cities;
+    vector<int> distances; // -1 where unreachable
+    vector<int> nextHop;   // index of the city after i on the way to j, -1 where
+                           // unreachable; empty unless requested
+    string message;
+    SearchStats stats;
+};
+
+// All-pairs shortest paths over the routes among a set of cities, for
+// regional sub-networks small enough for a dense matrix. Blocked
+// Floyd-Warshall over 64 x 64 blocks: each round closes the diagonal block,
+// then updates its block row and column and then every other block as
+// min-plus products spread over the pool. The product kernel uses AVX2 or
+// SSE4.1 when the CPU has it (checked at run time), plain loops otherwise.
+class AllPairs {
+public:
+    static const int MAX_CITIES = 5000;
+
+    // Every city when `cities` is empty; repeated names count once
+    static DistanceMatrixResult distances(Graph& g, const vector<string>& cities, bool withNextHop,
+                                          ThreadPool& pool, SearchStats* stats = nullptr);
+    // Cities from row i to column j along the next hops; empty if unreachable
+    static vector<string> path(const DistanceMatrixResult& matrix, int i, int j);
+    // "avx2", "sse4.1" or "scalar"
+    static const char* kernelName();
+};
+
+#endif // ALL_PAIRS_H
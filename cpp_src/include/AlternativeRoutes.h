@@ -0,0 +1,29 @@
+#ifndef ALTERNATIVE_ROUTES_H
+#define ALTERNATIVE_ROUTES_H
+
+#include "Graph.h"
+#include "KShortestPaths.h"
+#include "SearchStats.h"
+#include <string>
+
+// Meaningfully different routes by the plateau method. One forward tree
+// from the start and one backward tree from the destination, both bounded
+// by maxStretch times the shortest distance D. A plateau is a chain of
+// routes lying in both trees; it yields the route start -> plateau ->
+// destination, made of two overlapping shortest paths, so every subpath no
+// longer than the plateau is itself shortest. A route is kept when:
+//   - stretch: its distance is at most maxStretch * D
+//   - overlap: it shares at most maxOverlap * D with the routes kept so far
+//   - local optimality: its plateau is at least minLocalOptimality * D
+// Candidates are tried in order of distance minus plateau length until
+// maxRoutes routes are kept; paths[0] is the shortest path, the
+// alternatives follow shortest first.
+class AlternativeRoutes {
+public:
+    static PathListResult find(Graph& g, string start, string end, int maxRoutes, double maxStretch,
+                               double maxOverlap, double minLocalOptimality,
+                               SearchStats* stats = nullptr);
+    static bool validLimits(int maxRoutes, double maxStretch, double maxOverlap, double minLocalOptimality);
+};
+
+#endif // ALTERNATIVE_ROUTES_H
@@ -2,6 +2,7 @@
 #define CHEAPEST_NETWORK_H
 
 #include "Graph.h"
+#include "SearchStats.h"
 #include <string>
 #include <vector>
 #include <tuple>
@@ -11,11 +12,12 @@ struct MSTResult {
     vector<tuple<string, string, int>> edges; // (city1, city2, weight)
     int totalCost;
     string message;
+    SearchStats stats;
 };
 
 class CheapestNetwork {
 public:
-    static MSTResult find(Graph& g);
+    static MSTResult find(Graph& g, SearchStats* stats = nullptr);
 };
 
 #endif // CHEAPEST_NETWORK_H
@@ -0,0 +1,53 @@
+#ifndef CITIES_WITHIN_H
+#define CITIES_WITHIN_H
+
+#include "Graph.h"
+#include "SearchStats.h"
+#include "ThreadPool.h"
+#include <string>
+#include <vector>
+
+// A city around the start: its shortest distance, and the stops (routes)
+// of the path that distance was measured on
+struct CityDistance {
+    string city;
+    int distance;
+    int stops;
+};
+
+// Cities around the start, the start itself excluded
+struct CitiesWithinResult {
+    bool found;
+    vector<CityDistance> cities;
+    string message;
+    SearchStats stats;
+};
+
+// bands[i] holds the cities with radii[i-1] < distance <= radii[i]
+// (radii[-1] taken as 0, the start excluded); radii ascending
+struct IsochroneResult {
+    bool found;
+    vector<int> radii;
+    vector<vector<CityDistance>> bands;
+    string message;
+    SearchStats stats;
+};
+
+// Bounded searches out of one city: the Dijkstra stops at the radius, so
+// the work is proportional to the ball rather than the component.
+class CitiesWithin {
+public:
+    // Every city at most maxDistance away, nearest first
+    static CitiesWithinResult byDistance(Graph& g, string start, int maxDistance,
+                                         SearchStats* stats = nullptr);
+    // Every city at most maxStops stops away, fewest stops first; distance
+    // is the shortest among the fewest-stop routes (layered BFS)
+    static CitiesWithinResult byStops(Graph& g, string start, int maxStops,
+                                      SearchStats* stats = nullptr);
+    // One search to the largest radius, split into isochrone bands; with
+    // a pool the search is a parallel DeltaStepping::ball
+    static IsochroneResult bands(Graph& g, string start, vector<int> radii,
+                                 SearchStats* stats = nullptr, ThreadPool* pool = nullptr);
+};
+
+#endif // CITIES_WITHIN_H
@@ -0,0 +1,42 @@
+#ifndef COMPRESSED_ADJACENCY_H
+#define COMPRESSED_ADJACENCY_H
+
+#include "GraphSnapshot.h"
+#include <cstdint>
+#include <vector>
+
+// Read-only packed routes of every city, for networks whose adjacency lists
+// crowd worker memory (Graph::compress). Each city's routes are sorted by
+// target; the targets are gap-encoded (the first relative to the city,
+// zigzagged) in Stream VByte: one control byte of four 2-bit lengths per
+// four gaps, then the gaps in 1 to 4 bytes each. Weights are bit-packed at
+// the width of the network's weight range, at the city's arc offset.
+// Decoded four routes at a time as an ArcIterator walks a city, with an
+// SSSE3 shuffle per four gaps when the CPU has it.
+class CompressedAdjacency {
+public:
+    // lists[id] holds the routes of city id
+    explicit CompressedAdjacency(const vector<vector<Arc>>& lists);
+
+    int idCount() const { return (int)firstArc.size() - 1; }
+    size_t degree(int id) const { return firstArc[id + 1] - firstArc[id]; }
+    ArcRange arcsOf(int id) const;
+
+    // Heap bytes held, and what the same lists take as vector<vector<Arc>>
+    size_t memoryBytes() const;
+    static size_t listBytes(const vector<vector<Arc>>& lists);
+    // "ssse3" or "scalar"
+    static const char* decoderName();
+
+private:
+    friend class ArcIterator;
+
+    vector<uint64_t> firstArc;  // arcs before each city, idCount() + 1
+    vector<uint64_t> firstByte; // start of each city's control bytes, idCount() + 1
+    vector<uint8_t> bytes;      // control and gap bytes, padded for 16-byte loads
+    vector<uint8_t> weights;    // weight - weightBase in weightBits bits per arc, padded for 8-byte loads
+    int32_t weightBase = 0;
+    int weightBits = 0;
+};
+
+#endif // COMPRESSED_ADJACENCY_H
@@ -0,0 +1,32 @@
+#ifndef CONNECTED_COMPONENTS_H
+#define CONNECTED_COMPONENTS_H
+
+#include "Graph.h"
+#include "SearchStats.h"
+#include "ThreadPool.h"
+#include <string>
+#include <vector>
+
+// Component membership for the whole network, indexed by city id like
+// PathFinder::exportNames. Components are numbered largest first (ties by
+// lowest city id), so component 0 is the main network.
+struct ComponentsResult {
+    bool found;
+    vector<int32_t> component; // per city id, -1 for an id with no routes
+    vector<int32_t> sizes;     // cities per component
+    string message;
+    SearchStats stats;
+};
+
+// Parallel connected components by Afforest (Sutton et al.): union-find
+// over an array of parent ids, linked by compare-and-swap so every task can
+// hook trees at once. The first two routes of each city are linked and the
+// trees flattened; a sample then finds the component that is already
+// largest, and only cities outside it link their remaining routes. On
+// networks with one dominant component most routes are never touched.
+class ConnectedComponents {
+public:
+    static ComponentsResult label(const Graph& g, ThreadPool& pool, SearchStats* stats = nullptr);
+};
+
+#endif // CONNECTED_COMPONENTS_H
@@ -0,0 +1,71 @@
+#ifndef CUSTOMIZABLE_HIERARCHY_H
+#define CUSTOMIZABLE_HIERARCHY_H
+
+#include "Graph.h"
+#include "SearchStats.h"
+#include "ShortestPath.h"
+#include <climits>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Customizable contraction hierarchy (CCH). Preprocessing looks at the
+// topology only: cities are ranked by nested dissection (BFS level
+// separators, each separator above both halves) and contracted in rank
+// order into a chordal supergraph of upward arcs. Distances enter in a
+// separate customization pass over lower triangles. A changed route then
+// repairs only the arcs whose triangles it feeds (partial customization),
+// so the index survives weight updates; only new routes between cities the
+// supergraph does not already connect need a rebuild. Queries walk the
+// elimination tree upward from both ends, without a priority queue.
+class CustomizableHierarchy {
+public:
+    explicit CustomizableHierarchy(const Graph& g); // ranks, contracts and customizes
+
+    int idCount() const { return (int)rankOf.size(); }
+    size_t arcCount() const { return head.size(); }
+    size_t shortcutCount() const { return head.size() - routeArcs; }
+    int height() const { return treeHeight; }
+
+    // Sets the distance of route a-b (-1: removed) and repairs the arcs that
+    // depend on it. False, with nothing changed, if a-b is not an arc.
+    bool updateWeight(int a, int b, int weight);
+    // The same for a batch; each dependent arc is repaired once
+    bool updateWeights(const vector<RouteRecord>& routes);
+
+    ShortestPathResult query(Graph& g, const string& start, const string& end,
+                             SearchStats* stats = nullptr) const;
+
+private:
+    static constexpr int UNREACHABLE = INT_MAX;
+
+    vector<int> rankOf;   // city id -> rank
+    vector<int> cityAt;   // rank -> city id
+    vector<int> parent;   // elimination tree by rank, -1 at roots
+    int treeHeight = 0;
+    size_t routeArcs = 0; // arcs that were routes when built
+
+    // Upward arcs grouped by lower rank, upper ranks ascending
+    vector<int> firstUp;
+    vector<int> head;
+    vector<int> tail;
+    // The same arcs grouped by upper rank, lower ranks ascending
+    vector<int> firstDown;
+    vector<int> downTail;
+    vector<int> downArc;
+
+    vector<int> input;  // route distance, UNREACHABLE if none
+    vector<int> metric; // customized distance
+
+    // Arcs queued by the current partial customization
+    vector<uint32_t> queuedStamp;
+    uint32_t repairRound = 0;
+
+    int findArc(int a, int b) const; // by rank, either order; -1 if none
+    int viaLower(int arc) const;     // best lower triangle of arc
+    void customize();
+    void repair(const vector<int>& arcs);
+    void unpack(int from, int to, vector<int>& ranks) const;
+};
+
+#endif // CUSTOMIZABLE_HIERARCHY_H
@@ -0,0 +1,57 @@
+#ifndef DELTA_STEPPING_H
+#define DELTA_STEPPING_H
+
+#include "Graph.h"
+#include "CitiesWithin.h"
+#include "SearchStats.h"
+#include "ThreadPool.h"
+#include <climits>
+#include <string>
+#include <vector>
+
+// A city settled by a one-to-all search; parent -1 at the source
+struct SettledCity {
+    int id;
+    int distance;
+    int parent;
+};
+
+// Distances from each source (rows) to each target (columns), row-major
+struct DistanceTableResult {
+    bool found;
+    vector<string> sources;
+    vector<string> targets;
+    vector<int> distances; // -1 where unreachable
+    string message;
+    SearchStats stats;
+};
+
+// Parallel single-source shortest paths by delta-stepping (Meyer and
+// Sanders), for one-to-all work on large networks. Tentative distances
+// fall into buckets of width delta. The lowest bucket is settled in rounds
+// that relax its light routes (at most delta long) in parallel until it
+// stops refilling, then its heavy routes once. Distance and parent share
+// one 64-bit word updated by compare-and-swap, so they always match.
+// Each search allocates per-city arrays, so it pays off on large balls;
+// small ones are cheaper with the plain Dijkstra.
+class DeltaStepping {
+public:
+    // Mean length of a sample of routes, at least 1
+    static int autoDelta(const Graph& g);
+
+    // Cities at most maxDistance from source, in no particular order.
+    // delta <= 0 picks autoDelta(g).
+    static vector<SettledCity> run(const Graph& g, int source, int maxDistance, int delta,
+                                   ThreadPool& pool, SearchStats* stats = nullptr);
+    // The same ball nearest first, stops counted along the parents
+    static vector<CityDistance> ball(const Graph& g, int source, int maxDistance, ThreadPool& pool,
+                                     SearchStats* stats = nullptr);
+
+    // Every city reachable from start, nearest first
+    static CitiesWithinResult allFrom(Graph& g, string start, ThreadPool& pool, SearchStats* stats = nullptr);
+    // One search per source
+    static DistanceTableResult table(Graph& g, const vector<string>& sources, const vector<string>& targets,
+                                     ThreadPool& pool, SearchStats* stats = nullptr);
+};
+
+#endif // DELTA_STEPPING_H
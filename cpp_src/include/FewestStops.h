@@ -2,6 +2,7 @@
 #define FEWEST_STOPS_H
 
 #include "Graph.h"
+#include "SearchStats.h"
 #include <string>
 #include <vector>
 
@@ -10,11 +11,12 @@ struct FewestStopsResult {
     vector<string> path;
     int stops;
     string message;
+    SearchStats stats;
 };
 
 class FewestStops {
 public:
-    static FewestStopsResult find(Graph& g, string start, string end);
+    static FewestStopsResult find(Graph& g, string start, string end, SearchStats* stats = nullptr);
 };
 
 #endif // FEWEST_STOPS_H
@@ -2,32 +2,106 @@
 #define GRAPH_H
 
 #include <map>
+#include <memory>
+#include <unordered_map>
 #include <vector>
 #include <string>
+#include <string_view>
 #include <tuple>
 #include "DataStructures.h"
+#include "GraphSnapshot.h"
+#include "CompressedAdjacency.h"
+#include "NameFold.h"
 
 struct Edge {
     string dest;
     int weight;
 };
 
+// One buffered route of a bulk load, endpoints already interned
+struct RouteRecord {
+    int a;
+    int b;
+    int weight;
+};
+
+// Cities are numbered densely in order of first appearance. An id stays
+// reserved after the city loses its last route, so its spelling is kept.
 class Graph {
 private:
-    map<string, vector<Edge>> adjList;
-    map<string, string> lowerToOriginal; // lowercase -> original case
+    vector<string> names;              // id -> stored spelling
+    NameTable ids;                     // folded name -> id, keys live in names
+    vector<vector<Arc>> adj;           // id -> routes, both directions stored
+    int cityCount = 0;                 // ids with at least one route
+    size_t routeCount = 0;
+
+    // Read-only storage of a loaded snapshot. While set, the containers above
+    // are empty and every read goes to the mapping; the first write copies it
+    // into them (thaw) and drops the mapping.
+    shared_ptr<const GraphSnapshot> snapshot;
+    // Packed routes after compress(); adj is empty while set, names and
+    // ids stay as they are. Thawed the same way as a snapshot.
+    shared_ptr<const CompressedAdjacency> packed;
+
+    int lookup(string_view name) const;
+    int intern(const string& name);
+    void thaw();
+    void link(int a, int b, int w);
+    void eraseArc(int from, int to);
 
 public:
     void addEdge(string u, string v, int w);
     bool updateEdge(string u, string v, int w);
     void removeEdge(string u, string v);
     bool hasEdge(string u, string v);
+    int getEdgeWeight(string u, string v); // -1 if the edge does not exist
+    bool hasNode(const string& city);
+    string canonicalName(string city);     // stored spelling, or "" if unknown
     vector<Edge> getNeighbors(string u);
     vector<string> getNodes();
     void clear();
     int getCityCount();
     // Helper to get all edges for MST
     vector<tuple<int, string, string>> getAllEdges();
+
+    // Id-level access for the algorithms
+    int idCount() const;
+    int findCity(string_view name) const; // case-insensitive (NameFold), -1 if unknown
+    string_view nameOf(int id) const;
+    ArcRange neighbors(int id) const;
+    size_t degree(int id) const;
+    bool isCity(int id) const { return degree(id) > 0; }
+    size_t getRouteCount() const;
+
+    // Bulk path: intern names up front, then merge a whole batch of routes.
+    // Later records for the same city pair win, including over existing routes.
+    int internCity(const string& name);
+    size_t mergeRoutes(vector<RouteRecord>& records); // returns duplicates dropped
+
+    // Gives city order[i] the id i (order is a permutation of the ids, see
+    // GraphOrder). Names resolve as before; every id held outside the graph
+    // is invalidated. Route lists are reallocated in the new order so they
+    // sit in memory in it too.
+    void renumber(const vector<int>& order);
+
+    // Columnar export, indexed by city id: names as one byte blob with
+    // idCount() + 1 offsets, routes once each into getRouteCount() slots
+    void exportNames(char* bytes, int64_t* offsets) const;
+    size_t nameBytesSize() const;
+    void exportRoutes(int32_t* source, int32_t* target, int32_t* weight) const;
+
+    // Binary snapshot (see GraphSnapshot.h); load keeps the file mapped.
+    // journalSequence is stored with the routes and read back on load.
+    bool saveSnapshot(const string& path, string& error, int64_t journalSequence = 0);
+    bool loadSnapshot(const string& path, string& error, bool verify = false,
+                      int64_t* journalSequence = nullptr);
+    bool isMapped() const { return snapshot != nullptr; }
+
+    // Swaps the route lists for CompressedAdjacency; returns the bytes they
+    // took and the bytes the packed form takes. Reads decode on the fly;
+    // the first write unpacks them again.
+    pair<size_t, size_t> compress();
+    bool isCompressed() const { return packed != nullptr; }
 };
 
 #endif // GRAPH_H
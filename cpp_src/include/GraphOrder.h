@@ -0,0 +1,31 @@
+#ifndef GRAPH_ORDER_H
+#define GRAPH_ORDER_H
+
+#include "Graph.h"
+#include <string>
+#include <vector>
+
+// City orders for Graph::renumber. Ids handed out in order of first
+// appearance scatter neighbours across every per-city array, so searches
+// stall on cache misses; these orders give neighbours nearby ids. Each
+// returns a permutation of the ids, order[newId] = oldId, with ids that
+// have no routes kept at the end.
+class GraphOrder {
+public:
+    // Reverse Cuthill-McKee: BFS from a pseudo-peripheral city of each
+    // component, neighbours by ascending degree, reversed. Narrowest
+    // bandwidth on road-like networks.
+    static vector<int> reverseCuthillMcKee(const Graph& g);
+    // Plain BFS from the lowest id of each component
+    static vector<int> breadthFirst(const Graph& g);
+    // Highest degree first, so the hubs every search touches share lines
+    static vector<int> byDegree(const Graph& g);
+
+    // method is one of "rcm", "bfs", "degree"; false if unknown
+    static bool compute(const Graph& g, const string& method, vector<int>& order);
+    static vector<string> methods();
+    // Mean id distance across a route, the locality the orders minimize
+    static double meanGap(const Graph& g);
+};
+
+#endif // GRAPH_ORDER_H
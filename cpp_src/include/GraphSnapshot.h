@@ -0,0 +1,175 @@
+#ifndef GRAPH_SNAPSHOT_H
+#define GRAPH_SNAPSHOT_H
+
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace std;
+
+// Adjacency entry as stored both in memory and on disk
+struct Arc {
+    int32_t to;
+    int32_t weight;
+};
+
+class CompressedAdjacency;
+struct ArcRange;
+
+// End of an ArcRange; iterators compare against it
+struct ArcEnd {};
+
+// Walks a city's routes. Over plain storage it is a bare pointer; over
+// CompressedAdjacency it decodes the next four routes into `block` whenever
+// the current ones run out (refill, in CompressedAdjacency.cpp).
+class ArcIterator {
+public:
+    const Arc& operator*() const { return *at; }
+    const Arc* operator->() const { return at; }
+    ArcIterator& operator++() {
+        if (++at == stop && packed) refill();
+        return *this;
+    }
+    bool operator!=(ArcEnd) const { return at != stop; }
+    bool operator==(ArcEnd) const { return at == stop; }
+
+    ArcIterator(const ArcIterator& other) { *this = other; }
+    ArcIterator& operator=(const ArcIterator& other);
+
+private:
+    friend struct ArcRange;
+    ArcIterator(const Arc* first, const Arc* last) : at(first), stop(last) {}
+    ArcIterator(const CompressedAdjacency* packed, int id);
+    void refill();
+
+    const Arc* at;
+    const Arc* stop;
+    const CompressedAdjacency* packed = nullptr;
+    // Decoding position, set only over packed storage
+    const uint8_t* control;
+    const uint8_t* data;
+    uint64_t weightBit;
+    uint32_t next;     // routes decoded so far
+    uint32_t count;
+    int32_t previous;  // last decoded target, the city itself before the first
+    Arc block[4];
+};
+
+// A city's routes: a pointer pair into the graph's storage, or for
+// CompressedAdjacency the city whose packed routes begin() decodes
+struct ArcRange {
+    const Arc* first = nullptr;
+    const Arc* last = nullptr;
+    const CompressedAdjacency* packed = nullptr;
+    int32_t id = 0;
+    uint32_t count = 0;
+
+    ArcIterator begin() const { return packed ? ArcIterator(packed, id) : ArcIterator(first, last); }
+    ArcEnd end() const { return {}; }
+    size_t size() const { return packed ? count : last - first; }
+};
+
+inline ArcIterator& ArcIterator::operator=(const ArcIterator& other) {
+    packed = other.packed;
+    if (!packed) {
+        at = other.at;
+        stop = other.stop;
+        return *this;
+    }
+    // Re-point at this iterator's own copy of the block
+    control = other.control;
+    data = other.data;
+    weightBit = other.weightBit;
+    next = other.next;
+    count = other.count;
+    previous = other.previous;
+    for (int k = 0; k < 4; ++k) block[k] = other.block[k];
+    at = block + (other.at - other.block);
+    stop = block + (other.stop - other.block);
+    return *this;
+}
+
+// Binary graph snapshot, version 2. Little-endian, every section 64-byte aligned:
+//
+//   header          magic "PFGRAPH", version, counts, payload checksum, section table
+//   NAME_OFFSETS    uint64[ids + 1]   byte range of each stored city name
+//   NAME_BYTES      char[]            names in their stored spelling, not terminated
+//   NAME_INDEX      int32[slots]      open-addressing table, NameFold::hash -> id
+//   ARC_OFFSETS     uint64[ids + 1]   CSR row pointers
+//   ARCS            Arc[arcs]         both directions of every route
+//   JOURNAL         int64[1]          optional: last journal sequence the routes hold
+//
+// The file is mmap'd and read in place: nothing is parsed or copied on load.
+// Readers skip section kinds they do not know, so indexes can be appended
+// without a version bump. Version 2 changed the NAME_INDEX hash.
+enum SnapshotSectionKind : uint32_t {
+    SECTION_NAME_OFFSETS = 1,
+    SECTION_NAME_BYTES = 2,
+    SECTION_NAME_INDEX = 3,
+    SECTION_ARC_OFFSETS = 4,
+    SECTION_ARCS = 5,
+    SECTION_JOURNAL = 6,
+};
+
+struct SnapshotSection {
+    uint32_t kind;
+    const void* data;
+    uint64_t bytes;
+};
+
+class GraphSnapshot {
+public:
+    static const uint32_t VERSION = 2;
+
+    ~GraphSnapshot();
+    GraphSnapshot(const GraphSnapshot&) = delete;
+    GraphSnapshot& operator=(const GraphSnapshot&) = delete;
+
+    // Returns nullptr and fills error if the file is missing, truncated,
+    // from another version or has out-of-range sections, offsets, route
+    // targets or name slots. The payload checksum is only checked on request.
+    static shared_ptr<const GraphSnapshot> open(const string& path, string& error,
+                                                bool verify = false);
+    static bool write(const string& path, const vector<SnapshotSection>& sections,
+                      uint64_t cityCount, uint64_t routeCount, string& error);
+
+    // NAME_INDEX over the stored spellings, keyed by NameFold::hash
+    static vector<int32_t> buildNameIndex(const vector<string_view>& names);
+
+    int idCount() const { return (int)ids; }
+    int getCityCount() const { return (int)cities; }
+    size_t getRouteCount() const { return (size_t)routes; }
+    int64_t getJournalSequence() const { return journal; } // 0 without a JOURNAL section
+    string_view nameOf(int id) const;
+    ArcRange arcsOf(int id) const;
+    int lookup(string_view name) const; // case-insensitive, -1 if unknown
+
+    // Full payload checksum; false and fills error on mismatch
+    bool verify(string& error) const;
+
+private:
+    GraphSnapshot() {}
+
+    const char* base = nullptr;
+    size_t length = 0;
+    bool mapped = false;     // false: base points into fallback
+    vector<char> fallback;   // platforms without mmap read the file here
+
+    uint64_t ids = 0;
+    uint64_t cities = 0;
+    uint64_t routes = 0;
+    int64_t journal = 0;
+    const uint64_t* nameOffsets = nullptr;
+    const char* nameBytes = nullptr;
+    const int32_t* nameIndex = nullptr;
+    uint64_t nameSlots = 0;
+    const uint64_t* arcOffsets = nullptr;
+    const Arc* arcs = nullptr;
+
+    bool bind(string& error);
+};
+
+#endif // GRAPH_SNAPSHOT_H
@@ -0,0 +1,30 @@
+#ifndef K_SHORTEST_PATHS_H
+#define K_SHORTEST_PATHS_H
+
+#include "Graph.h"
+#include "SearchStats.h"
+#include "ShortestPath.h"
+#include <string>
+#include <vector>
+
+// Several routes between the same two cities, shortest first
+struct PathListResult {
+    bool found;
+    vector<ShortestPathResult> paths;
+    string message;
+    SearchStats stats;
+};
+
+// The k shortest loopless paths (Yen). One reverse Dijkstra from the
+// destination, stopped once the start is settled, serves every spur search:
+// as the A* heuristic, and as a shortcut - a spur search ends at the first
+// city whose tree path to the destination avoids the removed cities and
+// routes. Spurs start at each path's deviation point only (Lawler), and
+// candidates wait in a heap that is popped once per path found.
+class KShortestPaths {
+public:
+    static PathListResult find(Graph& g, string start, string end, int k,
+                               SearchStats* stats = nullptr);
+};
+
+#endif // K_SHORTEST_PATHS_H
@@ -2,6 +2,8 @@
 #define LONGEST_PATH_H
 
 #include "Graph.h"
+#include "QueryWorkspace.h"
+#include "SearchStats.h"
 #include <string>
 #include <vector>
 
@@ -10,15 +12,15 @@ struct LongestPathResult {
     vector<string> path;
     int distance;
     string message;
+    SearchStats stats;
 };
 
 class LongestPath {
 public:
-    static LongestPathResult find(Graph& g, string start, string end);
+    static LongestPathResult find(Graph& g, string start, string end, SearchStats* stats = nullptr);
 private:
-    static void dfsLongest(Graph& g, string current, string end, 
-                          map<string, bool>& visited, vector<string>& currentPath,
-                          int currentDist, vector<string>& bestPath, int& maxDist);
+    static void dfsLongest(Graph& g, int current, int end, QueryWorkspace& ws, StatsProbe& probe,
+                           int currentDist, vector<int>& bestPath, int& maxDist);
 };
 
 #endif // LONGEST_PATH_H
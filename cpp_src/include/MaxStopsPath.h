@@ -0,0 +1,42 @@
+#ifndef MAX_STOPS_PATH_H
+#define MAX_STOPS_PATH_H
+
+#include "Graph.h"
+#include "SearchStats.h"
+#include "ShortestPath.h"
+#include <string>
+#include <vector>
+
+// One point of the distance / stops trade-off
+struct StopsFrontEntry {
+    int stops;
+    int distance;
+    vector<string> path;
+};
+
+// Pareto front ordered by stops ascending; each entry is strictly shorter
+// than the one before, so the best route within s stops is the last entry
+// with stops <= s
+struct StopsFrontResult {
+    bool found;
+    vector<StopsFrontEntry> front;
+    string message;
+    SearchStats stats;
+};
+
+// Shortest routes using at most maxStops routes (stops as in
+// FewestStopsResult). An A* over (city, stops) labels, guided by distances
+// to the destination among the cities within maxStops of it. A label is dropped when its
+// city was already settled with no more stops, and when the stops left to
+// the destination (BFS) cannot fit the limit. Each city settles at most once
+// per distinct stop count, far fewer in practice, instead of maxStops
+// Bellman-Ford passes.
+class MaxStopsPath {
+public:
+    static ShortestPathResult find(Graph& g, string start, string end, int maxStops,
+                                   SearchStats* stats = nullptr);
+    static StopsFrontResult front(Graph& g, string start, string end, int maxStops,
+                                  SearchStats* stats = nullptr);
+};
+
+#endif // MAX_STOPS_PATH_H
@@ -0,0 +1,111 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "Tracer.h"
+
+using namespace std;
+
+// PathFinder operations, named after their Python methods
+enum class MetricOp {
+    AddCity, UpdateCity, RemoveCity, AddRoutes, LoadRoutesFile, AddRoutesArrays,
+    FindShortestPath, FindLongestPath, FindFewestStops, FindReachableCities,
+    PlanMultiCityTour, FindCheapestNetwork, GetAllCities, GetAllRoutes, ClearAll,
+    ExportNames, ExportRoutes, CityIds, Save, Load,
+    FindShortestPathWithMaxStops, FindStopsParetoFront, FindKShortestPaths,
+    FindAlternativeRoutes, CitiesWithin, CitiesWithinStops, IsochroneBands,
+    NearestCities, BuildHierarchy, UpdateRoutes, DistanceMatrix, DistancesFrom, DistanceTable,
+    ConnectedComponents, Reorder, Compress, ApplyChanges,
+    Count
+};
+
+enum class MetricOutcome { Ok, UnknownCity, NoRoute, InvalidInput, IoError, Count };
+
+const int METRIC_OPS = (int)MetricOp::Count;
+const int METRIC_OUTCOMES = (int)MetricOutcome::Count;
+
+// HDR-style log-bucketed latency histogram in nanoseconds: each power of
+// two is split into 4 linear sub-buckets, so a bucket bound is within 25% of
+// any value it holds. Covers 64ns to ~275s; outliers go to the end buckets.
+struct LatencyBuckets {
+    static const int SUB_BITS = 2;
+    static const int MIN_EXP = 6;
+    static const int MAX_EXP = 37;
+    static const int COUNT = ((MAX_EXP - MIN_EXP + 1) << SUB_BITS) + 2;
+
+    static int bucketOf(uint64_t nanos);
+    static uint64_t upperBound(int bucket); // exclusive, in nanoseconds
+};
+
+// Totals of one operation across all threads
+struct OperationSnapshot {
+    string operation;
+    uint64_t calls = 0;
+    array<uint64_t, METRIC_OUTCOMES> outcomes{};
+    uint64_t totalNanos = 0;
+    uint64_t maxNanos = 0;
+    vector<uint64_t> buckets;          // LatencyBuckets::COUNT entries
+
+    double quantileSeconds(double q) const; // upper bound of the bucket holding q
+};
+
+// Process-wide registry of PathFinder call counts, outcomes and latencies.
+// Each thread records into its own shard with relaxed atomics, so recording
+// never takes a lock or contends on a cache line; readers sum the shards.
+// A shard is folded into a retired total when its thread exits.
+class Metrics {
+public:
+    static Metrics& global();
+
+    void record(MetricOp op, MetricOutcome outcome, uint64_t nanos);
+
+    vector<OperationSnapshot> snapshot(bool reset = false);
+    void reset() { snapshot(true); }
+    string prometheusText(); // text exposition format 0.0.4
+
+    static const char* opName(MetricOp op);
+    static const char* outcomeName(MetricOutcome outcome);
+
+    struct Shard;
+
+private:
+    Metrics();
+    Metrics(const Metrics&) = delete;
+    Metrics& operator=(const Metrics&) = delete;
+
+    mutex shardsMutex;
+    vector<shared_ptr<Shard>> shards;
+    shared_ptr<Shard> retired;
+
+    Shard& local();
+    void retire(const shared_ptr<Shard>& shard);
+
+    friend struct ShardHandle;
+};
+
+// Times one PathFinder call (lock waits included) and records it when it
+// goes out of scope. The outcome stays Ok unless fail() is called. The call
+// is also a trace span named after the operation.
+class MetricTimer {
+    MetricOp op;
+    MetricOutcome outcome = MetricOutcome::Ok;
+    TraceSpan span;
+    chrono::steady_clock::time_point started;
+public:
+    explicit MetricTimer(MetricOp op)
+        : op(op), span(Metrics::opName(op)), started(chrono::steady_clock::now()) {}
+    ~MetricTimer();
+    MetricTimer(const MetricTimer&) = delete;
+    MetricTimer& operator=(const MetricTimer&) = delete;
+
+    void fail(MetricOutcome why) { outcome = why; }
+};
+
+#endif // METRICS_H
@@ -2,6 +2,7 @@
 #define MULTI_CITY_TOUR_H
 
 #include "Graph.h"
+#include "SearchStats.h"
 #include <string>
 #include <vector>
 
@@ -10,15 +11,16 @@ struct TourResult {
     vector<string> path;
     int totalDistance;
     string message;
+    SearchStats stats;
 };
 
 class MultiCityTour {
 public:
-    static TourResult plan(Graph& g, vector<string> cities);
+    static TourResult plan(Graph& g, vector<string> cities, SearchStats* stats = nullptr);
 private:
     static void tspHelper(Graph& g, vector<string>& cities, vector<bool>& visited, 
                          string current, int count, int cost, int& minCost, 
-                         vector<string>& currentPath, vector<string>& bestPath);
+                         vector<string>& currentPath, vector<string>& bestPath, StatsProbe& probe);
 };
 
 #endif // MULTI_CITY_TOUR_H
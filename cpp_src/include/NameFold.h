@@ -0,0 +1,55 @@
+#ifndef NAME_FOLD_H
+#define NAME_FOLD_H
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace std;
+
+// Case-insensitive hashing and comparison of city names, straight on the
+// stored bytes. Folding lowercases ASCII and the cased letters of Latin-1,
+// Latin Extended-A, Greek and Cyrillic. Every mapping keeps the UTF-8
+// length, so folded names compare byte for byte. Scripts without case
+// (Ethiopic, CJK, ...) and malformed bytes pass through unchanged. Runs of
+// pure ASCII are folded 16 (SSE2) or 8 bytes at a time.
+class NameFold {
+public:
+    // Stable across runs and builds: snapshots persist it (little-endian)
+    static uint64_t hash(string_view name);
+    static bool equal(string_view a, string_view b);
+    static string fold(string_view name);
+
+    // Folds name[pos..] into out, at most room bytes (room >= 2), and
+    // advances pos. Never splits a UTF-8 sequence; returns bytes written.
+    static size_t foldChunk(string_view name, size_t& pos, char* out, size_t room);
+};
+
+// Open-addressing index from folded name to id. Slots hold only ids and a
+// hash tag; the names stay in the caller's vector, so a lookup is a single
+// probe sequence with no key copies.
+class NameTable {
+private:
+    struct Slot {
+        int32_t id;   // -1 if empty
+        uint32_t tag; // high half of the hash
+    };
+    vector<Slot> slots; // power of two, at most half full
+    size_t used = 0;
+
+    void rehash(size_t count, const vector<string>& names);
+
+public:
+    int find(string_view name, const vector<string>& names) const {
+        return find(name, NameFold::hash(name), names);
+    }
+    int find(string_view name, uint64_t hash, const vector<string>& names) const; // -1 if unknown
+    void insert(int id, uint64_t hash, const vector<string>& names); // id must be new
+    void reserve(size_t count, const vector<string>& names);
+    void clear();
+    size_t size() const { return used; }
+};
+
+#endif // NAME_FOLD_H
@@ -0,0 +1,23 @@
+#ifndef NEAREST_CITIES_H
+#define NEAREST_CITIES_H
+
+#include "Graph.h"
+#include "CitiesWithin.h"
+#include "SearchStats.h"
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// The k cities nearest to the start (the start itself excluded), nearest
+// first. Only cities in `candidates` (when not empty) that pass `filter`
+// (when set) count. The Dijkstra stops once k of them are settled, or every
+// candidate is, so the work is the explored ball, not the component.
+class NearestCities {
+public:
+    static CitiesWithinResult find(Graph& g, string start, int k, const vector<string>& candidates,
+                                   const function<bool(string_view)>& filter,
+                                   SearchStats* stats = nullptr);
+};
+
+#endif // NEAREST_CITIES_H
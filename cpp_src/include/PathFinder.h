@@ -2,12 +2,32 @@
 #define PATH_FINDER_H
 
 #include "Graph.h"
+#include "GraphOrder.h"
 #include "ShortestPath.h"
+#include "ShortestPathTree.h"
+#include "CustomizableHierarchy.h"
 #include "FewestStops.h"
 #include "ReachableCities.h"
+#include "ConnectedComponents.h"
+#include "CitiesWithin.h"
+#include "NearestCities.h"
 #include "MultiCityTour.h"
 #include "CheapestNetwork.h"
 #include "LongestPath.h"
+#include "MaxStopsPath.h"
+#include "KShortestPaths.h"
+#include "AlternativeRoutes.h"
+#include "AllPairs.h"
+#include "DeltaStepping.h"
+#include "RouteLoader.h"
+#include "RouteJournal.h"
+#include "ThreadPool.h"
+#include "SearchStats.h"
+#include "Metrics.h"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
 #include <string>
 #include <vector>
 #include <tuple>
@@ -17,30 +37,167 @@ struct OperationResult {
     string message;
 };
 
+// Safe to share between threads: queries run concurrently under a shared
+// lock, mutations take it exclusively. Every public call is counted and
+// timed in Metrics::global().
 class PathFinder {
 private:
     Graph graph;
+    mutable shared_mutex graphMutex;
+
+    // Shortest-path trees of sources queried repeatedly, most recent last.
+    // Repaired incrementally on every route mutation instead of discarded.
+    // Other sources are answered by an early-exit ShortestPath::find; a
+    // source gets a tree on its TREE_AFTER_QUERIES-th miss among the last
+    // RECENT_SOURCES ones.
+    static const size_t MAX_CACHED_TREES = 8;
+    static const size_t RECENT_SOURCES = 64;
+    static const int TREE_AFTER_QUERIES = 3;
+    vector<shared_ptr<ShortestPathTree>> treeCache;
+    vector<int> recentSources; // ring of source ids answered without a tree
+    size_t recentNext = 0;
+    mutex cacheMutex;
+
+    // Built on request; serves findShortestPath while present. Route weight
+    // changes are customized in, new routes the hierarchy does not cover
+    // (and bulk loads) drop it until the next build.
+    unique_ptr<CustomizableHierarchy> hierarchy;
+
+    // Last RouteChange sequence applied (applyChanges); guarded by graphMutex
+    int64_t journalSeq = 0;
+    // Journal batches larger than this drop the cached trees instead of
+    // repairing them once per change
+    static const size_t MAX_REPAIRED_CHANGES = 16;
+
+    // Created on first use; declared last so it is joined before the graph goes
+    once_flag poolOnce;
+    unique_ptr<ThreadPool> pool;
+    ThreadPool& workers();
+
+    atomic<bool> collectStats{false};
+    SearchStats* statsTarget(SearchStats& stats) const; // null unless collecting
+    MetricOutcome missOutcome(const vector<string>& cities);
+
+    // Cached tree of source, built if the source is hot; null otherwise
+    shared_ptr<const ShortestPathTree> treeFor(int source, SearchStats* stats = nullptr);
+    void repairTrees(const string& city1, const string& city2, int oldWeight, int newWeight);
+    void dropTrees();
+    void updateHierarchy(const string& city1, const string& city2, int newWeight);
 
 public:
     PathFinder() {}
+    PathFinder(const PathFinder&) = delete;
+    PathFinder& operator=(const PathFinder&) = delete;
+
+    // Process-wide engine behind both Python modules; never destroyed
+    static PathFinder& shared();
 
     // Graph operations
     OperationResult addCity(string city1, string city2, int distance);
     OperationResult updateCity(string city1, string city2, int distance);
     OperationResult removeCity(string city1, string city2);
-    
+
+    // Bulk ingestion: rows are buffered, deduplicated (last one wins) and
+    // merged in a single pass. Invalid rows are counted, not fatal.
+    BulkLoadResult addRoutes(const vector<tuple<string, string, int>>& routes);
+    BulkLoadResult loadRoutesFile(string path);
+    BulkLoadResult addRoutesColumns(const vector<string>& names, const int32_t* source,
+                                    const int32_t* target, const int32_t* weight, size_t count);
+    // New distances for existing routes in one pass; unknown routes and
+    // non-positive distances are skipped and counted
+    OperationResult updateRoutes(const vector<tuple<string, string, int>>& routes);
+
+    // Mutation journal: applies the changes numbered after journalSequence()
+    // in sequence order under one exclusive lock, and skips the rest, so a
+    // writer can replay its change log from any earlier point. Trees and the
+    // hierarchy are repaired as for single mutations.
+    JournalResult applyChanges(const vector<RouteChange>& changes);
+    int64_t journalSequence();
+    // After a full reload: the graph holds every change up to sequence.
+    // clearAll() and load() reset it to 0.
+    void setJournalSequence(int64_t sequence);
+
+    // Customizable contraction hierarchy over the current routes
+    OperationResult buildHierarchy();
+    bool hasHierarchy();
+
+    // Renumbers the cities for cache locality (GraphOrder::compute method).
+    // Names are unaffected; ids from cityIds/exportNames change. Cached
+    // trees are dropped and a hierarchy is rebuilt.
+    OperationResult reorder(string method = "rcm");
+
+    // Packs the route lists (Graph::compress) to save memory on very large
+    // networks; queries decode as they go, the next mutation unpacks them
+    OperationResult compress();
+    bool isCompressed();
+
     // Query operations
     ShortestPathResult findShortestPath(string start, string end);
     LongestPathResult findLongestPath(string start, string end);
     FewestStopsResult findFewestStops(string start, string end);
+    ShortestPathResult findShortestPathWithMaxStops(string start, string end, int maxStops);
+    StopsFrontResult findStopsParetoFront(string start, string end, int maxStops);
+    PathListResult findKShortestPaths(string start, string end, int k);
+    // The shortest path plus up to maxRoutes - 1 distinct alternatives
+    PathListResult findAlternativeRoutes(string start, string end, int maxRoutes = 3,
+                                         double maxStretch = 1.25, double maxOverlap = 0.8,
+                                         double minLocalOptimality = 0.25);
     vector<string> findReachableCities(string start);
+    // Component of every city id, largest component first; runs on the
+    // engine's pool
+    ComponentsResult connectedComponents();
+    CitiesWithinResult citiesWithin(string start, int maxDistance);
+    CitiesWithinResult citiesWithinStops(string start, int maxStops);
+    // parallel: search with DeltaStepping on the engine's pool, for large balls
+    IsochroneResult isochroneBands(string start, vector<int> radii, bool parallel = false);
+    // filter runs under the engine's shared lock and must not call back in
+    CitiesWithinResult nearestCities(string start, int k, vector<string> candidates = {},
+                                     function<bool(string_view)> filter = nullptr);
     TourResult planMultiCityTour(vector<string> cities);
+    // Dense all-pairs distances over the routes among `cities` (every city
+    // when empty), at most AllPairs::MAX_CITIES; runs on the engine's pool
+    DistanceMatrixResult distanceMatrix(vector<string> cities = {}, bool withNextHop = false);
+    // One-to-all and many-to-many distances over the whole network by
+    // parallel delta-stepping on the engine's pool
+    CitiesWithinResult distancesFrom(string start);
+    DistanceTableResult distanceTable(vector<string> sources, vector<string> targets);
     MSTResult findCheapestNetwork();
     
     // Get graph data
     vector<string> getAllCities();
     vector<tuple<string, string, int>> getAllRoutes();
     void clearAll();
+
+    // Maintained on every mutation, O(1)
+    bool hasCity(const string& city);
+    int cityCount();
+    size_t routeCount();
+
+    // Columnar transfer, indexed by city id (see Graph::exportRoutes)
+    void exportNames(vector<uint8_t>& bytes, vector<int64_t>& offsets) const;
+    void exportRoutes(vector<int32_t>& source, vector<int32_t>& target, vector<int32_t>& weight) const;
+    int cityId(const string& name) const;
+    vector<int32_t> cityIds(const vector<string>& names) const;
+
+    // Binary snapshot of the whole network. load() maps the file read-only,
+    // so the engine is query-ready without replaying routes; the first
+    // mutation afterwards copies the graph into memory. Only the header and
+    // section bounds are checked unless verify asks for the full checksum.
+    // The journal sequence is saved with the routes and restored by load().
+    OperationResult save(string path);
+    OperationResult load(string path, bool verify = false);
+
+    // Per-query SearchStats on every result; off by default
+    void setCollectStats(bool enabled) { collectStats.store(enabled); }
+    bool collectsStats() const { return collectStats.load(); }
+
+    // Runs work on the engine's own worker threads
+    void submit(function<void()> work);
+
+    template <typename F>
+    future<invoke_result_t<F>> async(F work) {
+        return workers().async(move(work));
+    }
 };
 
 #endif // PATH_FINDER_H
@@ -0,0 +1,75 @@
+#ifndef QUERY_WORKSPACE_H
+#define QUERY_WORKSPACE_H
+
+#include "Graph.h"
+#include <climits>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Scratch state of one graph query, indexed by city id and reused across
+// queries. Every entry is stamped with the generation that wrote it, so a
+// new query starts in O(1): bump the generation and all old entries read as
+// unset. Each thread owns one workspace per slot; a query must not start
+// another query while it still uses it.
+class QueryWorkspace {
+public:
+    // Queries that keep one search alive while running others (e.g. spur
+    // searches over a reverse tree) use one slot for each
+    static const int SLOTS = 2;
+
+    // The calling thread's workspace in `slot`, reset for a graph with
+    // `ids` city ids
+    static QueryWorkspace& acquire(int ids, int slot = 0);
+
+    // Tentative distance and parent (Dijkstra labels, BFS tree)
+    bool reached(int id) const { return reachStamp[id] == generation; }
+    int dist(int id) const { return reached(id) ? distance[id] : INT_MAX; }
+    int parentOf(int id) const { return parent[id]; }
+    void reach(int id, int d, int p) {
+        reachStamp[id] = generation;
+        distance[id] = d;
+        parent[id] = p;
+    }
+
+    // Settled / on-path flags
+    bool visited(int id) const { return visitStamp[id] == generation; }
+    void visit(int id) { visitStamp[id] = generation; }
+    void unvisit(int id) { visitStamp[id] = 0; }
+
+    // Extra per-city values of label searches: a bound (e.g. fewest stops
+    // settled at a city) and a hop count (e.g. stops left to a target).
+    // Both read as INT_MAX until set.
+    int bound(int id) const { return boundStamp[id] == generation ? bounds[id] : INT_MAX; }
+    void setBound(int id, int value) {
+        boundStamp[id] = generation;
+        bounds[id] = value;
+    }
+    int hops(int id) const { return hopStamp[id] == generation ? hopCounts[id] : INT_MAX; }
+    void setHops(int id, int value) {
+        hopStamp[id] = generation;
+        hopCounts[id] = value;
+    }
+
+    // Stored names from the root of the parent links down to id
+    vector<string> pathTo(const Graph& g, int id) const;
+
+    IdMinPQ heap;
+    vector<int> frontier; // BFS queue or DFS stack
+    vector<int> path;     // current DFS path
+
+private:
+    uint32_t generation = 0;
+    vector<uint32_t> reachStamp;
+    vector<uint32_t> visitStamp;
+    vector<uint32_t> boundStamp;
+    vector<uint32_t> hopStamp;
+    vector<int> distance;
+    vector<int> parent;
+    vector<int> bounds;
+    vector<int> hopCounts;
+
+    void reset(int ids);
+};
+
+#endif // QUERY_WORKSPACE_H
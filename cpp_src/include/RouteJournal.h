@@ -0,0 +1,47 @@
+#ifndef ROUTE_JOURNAL_H
+#define ROUTE_JOURNAL_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+enum class RouteChangeKind { Add, Update, Remove };
+
+// One recorded route mutation. Sequence numbers come from the writer's
+// change log (e.g. the database row id): increasing, not necessarily dense.
+struct RouteChange {
+    int64_t sequence;
+    RouteChangeKind kind;
+    string city1;
+    string city2;
+    int distance; // ignored for Remove
+};
+
+struct JournalResult {
+    bool success;
+    int64_t sequence;   // last sequence the engine has applied, after the batch
+    long long applied;
+    long long skipped;  // at or below the engine's sequence already
+    long long rejected; // non-positive distance or missing city name
+    string message;     // summary, plus the first rejection if any
+};
+
+// Helpers for PathFinder::applyChanges. Every kind is applied as the state
+// it leaves behind (Add and Update set the distance, Remove drops the route
+// if present), so replaying changes the engine has partly seen converges on
+// the writer's state.
+class RouteJournal {
+public:
+    // "add", "update" or "remove"; false if unknown
+    static bool kindNamed(const string& name, RouteChangeKind& kind);
+    static const char* nameOf(RouteChangeKind kind);
+
+    // Changes after `since`, ordered by sequence (stable for equal ones);
+    // skipped counts the rest
+    static vector<const RouteChange*> pending(const vector<RouteChange>& changes, int64_t since,
+                                              long long& skipped);
+};
+
+#endif // ROUTE_JOURNAL_H
@@ -0,0 +1,52 @@
+#ifndef ROUTE_LOADER_H
+#define ROUTE_LOADER_H
+
+#include "Graph.h"
+#include <chrono>
+#include <string>
+#include <vector>
+
+struct BulkLoadResult {
+    bool success;
+    long long rowsRead;      // data rows seen; blank, comment and header lines excluded
+    long long rowsAccepted;
+    long long rowsRejected;
+    long long duplicates;    // accepted rows overridden by a later row for the same pair
+    double seconds;
+    double rowsPerSecond;
+    string message;          // summary, plus the first rejection if any
+};
+
+// Buffers routes as interned id triples and merges the whole batch into the
+// graph at commit() with one sort + one adjacency rebuild, instead of paying
+// a lookup, duplicate scan and possible removal per route.
+class RouteLoader {
+public:
+    explicit RouteLoader(Graph& g);
+
+    bool add(const string& u, const string& v, int w); // false if rejected
+    bool addLine(const string& line);                   // one CSV or TSV row
+    // Columnar rows; source/target index into names
+    void addColumns(const vector<string>& names, const int32_t* source, const int32_t* target,
+                    const int32_t* weight, size_t count);
+    BulkLoadResult commit();
+
+    // Streams "city1,city2,distance" rows (comma or tab separated, optional
+    // header, '#' comments, double-quoted fields) into the graph.
+    static BulkLoadResult loadFile(Graph& g, const string& path);
+
+private:
+    Graph& graph;
+    vector<RouteRecord> buffer;
+    long long rowsRead = 0;
+    long long rowsRejected = 0;
+    string firstError;
+    char delimiter = 0;      // detected on the first row
+    chrono::steady_clock::time_point started;
+
+    void reject(const string& reason);
+    static void splitFields(const string& line, char delim, vector<string>& fields);
+    static bool parseDistance(const string& field, int& out);
+};
+
+#endif // ROUTE_LOADER_H
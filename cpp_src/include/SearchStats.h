@@ -0,0 +1,87 @@
+#ifndef SEARCH_STATS_H
+#define SEARCH_STATS_H
+
+#include <chrono>
+#include <string>
+#include <utility>
+#include <vector>
+#include "Tracer.h"
+
+using namespace std;
+
+// Work done by one query. Filled in only while the engine collects stats
+// (PathFinder::setCollectStats), otherwise every field stays zero. Building
+// with -DPATHFINDER_NO_STATS compiles the instrumentation out entirely.
+struct SearchStats {
+    bool collected = false;
+    long long nodesSettled = 0;   // cities finalized by the search
+    long long edgesRelaxed = 0;   // routes examined
+    long long heapPushes = 0;
+    long long heapPops = 0;
+    long long staleSkipped = 0;   // popped heap entries that were already beaten
+    long long recursionNodes = 0; // backtracking calls
+    long long peakFrontier = 0;   // largest heap, queue, stack or DFS depth
+    vector<pair<string, double>> phases; // wall-clock milliseconds, in order
+};
+
+// Counter hooks used inside the algorithms. Holds null when stats are off,
+// so each hook costs one predictable branch.
+class StatsProbe {
+    SearchStats* s = nullptr;
+public:
+    StatsProbe() {}
+#ifdef PATHFINDER_NO_STATS
+    explicit StatsProbe(SearchStats*) {}
+    bool on() const { return false; }
+#else
+    explicit StatsProbe(SearchStats* target) : s(target) {}
+    bool on() const { return s != nullptr; }
+#endif
+
+    void settled() { if (on()) s->nodesSettled++; }
+    void relaxed() { if (on()) s->edgesRelaxed++; }
+    void pushed() { if (on()) s->heapPushes++; }
+    void popped() { if (on()) s->heapPops++; }
+    void stale() { if (on()) s->staleSkipped++; }
+    void recursed() { if (on()) s->recursionNodes++; }
+    void frontier(size_t size) {
+        if (on() && (long long)size > s->peakFrontier) s->peakFrontier = size;
+    }
+};
+
+// Splits a query into consecutive named phases: mark() ends the running
+// phase and starts the next, the destructor ends the last one. Phases are
+// also emitted as trace spans when the request is being traced.
+class PhaseTimer {
+    using Clock = chrono::steady_clock;
+    StatsProbe probe;
+    SearchStats* s;
+    bool tracing;
+    const char* current = nullptr;
+    Clock::time_point started;
+public:
+    explicit PhaseTimer(SearchStats* target)
+        : probe(target), s(target), tracing(Tracer::recording()) {}
+    ~PhaseTimer() { finish(); }
+    PhaseTimer(const PhaseTimer&) = delete;
+    PhaseTimer& operator=(const PhaseTimer&) = delete;
+
+    void mark(const char* phase) {
+        if (!probe.on() && !tracing) return;
+        finish();
+        current = phase;
+        started = Clock::now();
+    }
+
+    void finish() {
+        if (!current) return;
+        Clock::time_point ended = Clock::now();
+        if (probe.on()) {
+            s->phases.emplace_back(current, chrono::duration<double, milli>(ended - started).count());
+        }
+        if (tracing) Tracer::emit(current, started, ended);
+        current = nullptr;
+    }
+};
+
+#endif // SEARCH_STATS_H
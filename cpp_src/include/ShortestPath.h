@@ -2,6 +2,7 @@
 #define SHORTEST_PATH_H
 
 #include "Graph.h"
+#include "SearchStats.h"
 #include <string>
 #include <vector>
 
@@ -10,11 +11,12 @@ struct ShortestPathResult {
     vector<string> path;
     int distance;
     string message;
+    SearchStats stats;
 };
 
 class ShortestPath {
 public:
-    static ShortestPathResult find(Graph& g, string start, string end);
+    static ShortestPathResult find(Graph& g, string start, string end, SearchStats* stats = nullptr);
 };
 
 #endif // SHORTEST_PATH_H
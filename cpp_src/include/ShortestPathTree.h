@@ -0,0 +1,40 @@
+#ifndef SHORTEST_PATH_TREE_H
+#define SHORTEST_PATH_TREE_H
+
+#include "Graph.h"
+#include "ShortestPath.h"
+#include "SearchStats.h"
+#include <string>
+#include <vector>
+
+// Complete Dijkstra tree rooted at one source city, indexed by city id. It
+// is kept alive across graph mutations and repaired in place (Ramalingam-Reps):
+//  - a new edge or a shorter distance relaxes outward from the improved endpoint
+//  - a removed edge or a longer distance recomputes only the subtree below it
+// so the work done per mutation is proportional to the affected region.
+// Ids must stay stable while the tree lives (Graph::renumber invalidates it).
+class ShortestPathTree {
+public:
+    ShortestPathTree(const Graph& g, int source, SearchStats* stats = nullptr);
+
+    int getSource() const { return source; }
+    ShortestPathResult query(const Graph& g, int target) const;
+
+    // Must be called after the graph has been mutated; a weight of -1 means
+    // "edge absent" (before or after)
+    void edgeChanged(const Graph& g, int u, int v, int oldWeight, int newWeight);
+
+private:
+    int source;
+    vector<int> dist;   // INT_MAX where unreached
+    vector<int> parent; // -1 at the source and where unreached
+    IdMinPQ pq;
+
+    int distOf(int id) const { return id < (int)dist.size() ? dist[id] : INT_MAX; }
+    void fit(const Graph& g); // cities added since the build start unreached
+    void relax(const Graph& g, StatsProbe probe = StatsProbe());
+    void decrease(const Graph& g, int from, int to, int w);
+    void increase(const Graph& g, int root);
+};
+
+#endif // SHORTEST_PATH_TREE_H
@@ -0,0 +1,58 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+// Fixed set of worker threads draining a FIFO of tasks. The queue lives in
+// shared state owned by the workers too, so the pool may be destroyed from
+// inside one of its own tasks (that worker is detached and exits on its own).
+class ThreadPool {
+public:
+    explicit ThreadPool(unsigned threads = 0); // 0: one per hardware thread
+    ~ThreadPool();
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    void submit(function<void()> task);
+
+    template <typename F>
+    future<invoke_result_t<F>> async(F work) {
+        auto task = make_shared<packaged_task<invoke_result_t<F>()>>(move(work));
+        future<invoke_result_t<F>> result = task->get_future();
+        submit([task]() { (*task)(); });
+        return result;
+    }
+
+    // Runs body(0) .. body(count - 1) on the workers and the calling thread
+    // together and returns when all are done. The caller claims indices too,
+    // so this finishes even when called from a task with every worker busy.
+    // If body throws, the indices not yet claimed are skipped and the first
+    // exception is rethrown here once every helper has stopped.
+    void parallelFor(size_t count, const function<void(size_t)>& body);
+
+    unsigned size() const { return (unsigned)workers.size(); }
+
+private:
+    struct State {
+        mutex m;
+        condition_variable ready;
+        deque<function<void()>> tasks;
+        bool stopping = false;
+    };
+    shared_ptr<State> state;
+    vector<thread> workers;
+
+    static void run(shared_ptr<State> state);
+};
+
+#endif // THREAD_POOL_H
@@ -0,0 +1,80 @@
+#ifndef TRACER_H
+#define TRACER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Process-wide collector of timed spans, dumped in the Chrome trace event
+// format (chrome://tracing, ui.perfetto.dev). Off until start(). Sampling
+// is decided once per request: the outermost span on a thread rolls the
+// dice, and everything nested inside it is recorded or skipped with it.
+// Spans of a request are buffered per thread and published together when
+// the request ends; the oldest events are dropped beyond the capacity.
+class Tracer {
+public:
+    static Tracer& global();
+
+    void start(double sampleRate = 1.0, size_t capacity = 100000);
+    void stop();
+    bool enabled() const { return on.load(memory_order_relaxed); }
+
+    string json();
+    bool writeJson(const string& path, string& error);
+    void clear();
+
+    // True while this thread is inside a sampled request
+    static bool recording();
+    // Adds a finished span to the current request, if it is being recorded
+    static void emit(const char* name, chrono::steady_clock::time_point start,
+                     chrono::steady_clock::time_point end);
+
+    struct Event {
+        const char* name;     // string literals only
+        const char* category;
+        double start;         // microseconds since the tracer was created
+        double duration;
+        uint32_t thread;
+    };
+
+private:
+    Tracer();
+    Tracer(const Tracer&) = delete;
+    Tracer& operator=(const Tracer&) = delete;
+
+    atomic<bool> on{false};
+    atomic<double> rate{1.0};
+    chrono::steady_clock::time_point epoch;
+
+    mutex eventsMutex;
+    deque<Event> events;
+    size_t capacity = 100000;
+
+    bool sample();
+    double micros(chrono::steady_clock::time_point t) const;
+    void publish(vector<Event>& batch);
+
+    friend class TraceSpan;
+};
+
+// Times the enclosing scope as one trace event. Costs a thread-local read
+// when tracing is off or the request was not sampled.
+class TraceSpan {
+    const char* name;
+    const char* category;
+    double started = 0;
+    bool active;
+public:
+    explicit TraceSpan(const char* name, const char* category = "pathfinder");
+    ~TraceSpan();
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+};
+
+#endif // TRACER_H
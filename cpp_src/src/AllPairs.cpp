@@ -0,0 +1,275 @@
+#include "../include/AllPairs.h"
+#include <algorithm>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define ALL_PAIRS_X86
+#include <immintrin.h>
+#endif
+
+namespace {
+
+const int BLOCK = 64;
+const int FAR = 0x3fffffff; // unreachable; FAR + FAR still fits an int
+
+// Product kernel: c[i][j] = min(c[i][j], a[i][k] + b[k][j]) over the
+// block's k, with nc[i][j] = na[i][k] wherever that improves (nc null: no
+// next hops)
+using BlockKernel = void (*)(int* c, int* nc, const int* a, const int* na, const int* b, size_t stride);
+
+// Diagonal block: plain Floyd-Warshall within it, so k is the outer loop.
+// One block per round, so plain loops are enough.
+void closeBlock(int* c, int* nc, size_t stride) {
+    for (int k = 0; k < BLOCK; ++k) {
+        const int* ck = c + k * stride;
+        for (int i = 0; i < BLOCK; ++i) {
+            int cik = c[i * stride + k];
+            if (cik >= FAR) continue;
+            int* ci = c + i * stride;
+            for (int j = 0; j < BLOCK; ++j) {
+                int d = cik + ck[j];
+                if (d < ci[j]) {
+                    ci[j] = d;
+                    if (nc) nc[i * stride + j] = nc[i * stride + k];
+                }
+            }
+        }
+    }
+}
+
+// Every other block: a min-plus product, each row of c finished in one
+// pass over k while it stays hot. Once the diagonal block is closed, its
+// row and column blocks are products too, c being b or a: an entry read
+// after it improved is still the length of a real path, so the result is
+// the same.
+void scalarProduct(int* c, int* nc, const int* a, const int* na, const int* b, size_t stride) {
+    for (int i = 0; i < BLOCK; ++i) {
+        int* ci = c + i * stride;
+        int* ni = nc ? nc + i * stride : nullptr;
+        for (int k = 0; k < BLOCK; ++k) {
+            int aik = a[i * stride + k];
+            if (aik >= FAR) continue;
+            const int* bk = b + k * stride;
+            if (!ni) {
+                for (int j = 0; j < BLOCK; ++j) ci[j] = min(ci[j], aik + bk[j]);
+                continue;
+            }
+            int hop = na[i * stride + k];
+            for (int j = 0; j < BLOCK; ++j) {
+                int d = aik + bk[j];
+                if (d < ci[j]) {
+                    ci[j] = d;
+                    ni[j] = hop;
+                }
+            }
+        }
+    }
+}
+
+#ifdef ALL_PAIRS_X86
+
+// The whole row of c lives in 8 registers across the k loop
+__attribute__((target("avx2")))
+void avx2Product(int* c, int* nc, const int* a, const int* na, const int* b, size_t stride) {
+    const int LANES = 8, PARTS = BLOCK / LANES;
+    for (int i = 0; i < BLOCK; ++i) {
+        int* ci = c + i * stride;
+        int* ni = nc ? nc + i * stride : nullptr;
+        __m256i row[PARTS], hops[PARTS];
+#pragma GCC unroll 8
+        for (int t = 0; t < PARTS; ++t) {
+            row[t] = _mm256_loadu_si256((const __m256i*)(ci + t * LANES));
+            hops[t] = ni ? _mm256_loadu_si256((const __m256i*)(ni + t * LANES)) : _mm256_setzero_si256();
+        }
+        for (int k = 0; k < BLOCK; ++k) {
+            int aik = a[i * stride + k];
+            if (aik >= FAR) continue;
+            __m256i viaK = _mm256_set1_epi32(aik);
+            const int* bk = b + k * stride;
+            if (!ni) {
+#pragma GCC unroll 8
+                for (int t = 0; t < PARTS; ++t) {
+                    __m256i d = _mm256_add_epi32(viaK, _mm256_loadu_si256((const __m256i*)(bk + t * LANES)));
+                    row[t] = _mm256_min_epi32(row[t], d);
+                }
+                continue;
+            }
+            __m256i hop = _mm256_set1_epi32(na[i * stride + k]);
+#pragma GCC unroll 8
+            for (int t = 0; t < PARTS; ++t) {
+                __m256i d = _mm256_add_epi32(viaK, _mm256_loadu_si256((const __m256i*)(bk + t * LANES)));
+                hops[t] = _mm256_blendv_epi8(hops[t], hop, _mm256_cmpgt_epi32(row[t], d));
+                row[t] = _mm256_min_epi32(row[t], d);
+            }
+        }
+#pragma GCC unroll 8
+        for (int t = 0; t < PARTS; ++t) {
+            _mm256_storeu_si256((__m256i*)(ci + t * LANES), row[t]);
+            if (ni) _mm256_storeu_si256((__m256i*)(ni + t * LANES), hops[t]);
+        }
+    }
+}
+
+__attribute__((target("sse4.1")))
+void sse41Product(int* c, int* nc, const int* a, const int* na, const int* b, size_t stride) {
+    for (int i = 0; i < BLOCK; ++i) {
+        int* ci = c + i * stride;
+        int* ni = nc ? nc + i * stride : nullptr;
+        for (int k = 0; k < BLOCK; ++k) {
+            int aik = a[i * stride + k];
+            if (aik >= FAR) continue;
+            __m128i viaK = _mm_set1_epi32(aik);
+            const int* bk = b + k * stride;
+            __m128i hop = _mm_set1_epi32(ni ? na[i * stride + k] : 0);
+            for (int j = 0; j < BLOCK; j += 4) {
+                __m128i d = _mm_add_epi32(viaK, _mm_loadu_si128((const __m128i*)(bk + j)));
+                __m128i cur = _mm_loadu_si128((const __m128i*)(ci + j));
+                _mm_storeu_si128((__m128i*)(ci + j), _mm_min_epi32(cur, d));
+                if (!ni) continue;
+                __m128i better = _mm_cmpgt_epi32(cur, d);
+                __m128i hops = _mm_loadu_si128((const __m128i*)(ni + j));
+                _mm_storeu_si128((__m128i*)(ni + j), _mm_blendv_epi8(hops, hop, better));
+            }
+        }
+    }
+}
+
+#endif // ALL_PAIRS_X86
+
+struct Kernel {
+    BlockKernel product;
+    const char* name;
+};
+
+const Kernel& kernel() {
+    static const Kernel chosen = [] {
+#ifdef ALL_PAIRS_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) return Kernel{avx2Product, "avx2"};
+        if (__builtin_cpu_supports("sse4.1")) return Kernel{sse41Product, "sse4.1"};
+#endif
+        return Kernel{scalarProduct, "scalar"};
+    }();
+    return chosen;
+}
+
+} // namespace
+
+const char* AllPairs::kernelName() {
+    return kernel().name;
+}
+
+DistanceMatrixResult AllPairs::distances(Graph& g, const vector<string>& cities, bool withNextHop,
+                                         ThreadPool& pool, SearchStats* stats) {
+    DistanceMatrixResult res;
+    res.found = false;
+
+    PhaseTimer phases(stats);
+    phases.mark("resolve");
+
+    // column[id]: the city's row and column, -1 outside the matrix
+    vector<int> ids;
+    vector<int> column(g.idCount(), -1);
+    if (cities.empty()) {
+        for (int id = 0; id < g.idCount(); ++id) {
+            if (g.isCity(id)) ids.push_back(id);
+        }
+    } else {
+        for (const string& name : cities) {
+            int id = g.findCity(name);
+            if (id < 0 || !g.isCity(id)) {
+                res.message = "City not found in the network: " + name;
+                return res;
+            }
+            if (column[id] < 0) {
+                column[id] = (int)ids.size();
+                ids.push_back(id);
+            }
+        }
+    }
+    if ((int)ids.size() > MAX_CITIES) {
+        res.message = "At most " + to_string(MAX_CITIES) + " cities fit in a distance matrix.";
+        return res;
+    }
+    for (size_t i = 0; i < ids.size(); ++i) column[ids[i]] = (int)i;
+
+    // Padded to whole blocks; padding rows only reach themselves
+    phases.mark("workspace");
+    size_t n = ids.size();
+    size_t blocks = (n + BLOCK - 1) / BLOCK;
+    size_t stride = blocks * BLOCK;
+    vector<int> dist(stride * stride, FAR);
+    vector<int> next(withNextHop ? stride * stride : 0, -1);
+    for (size_t i = 0; i < stride; ++i) {
+        dist[i * stride + i] = 0;
+        if (withNextHop) next[i * stride + i] = (int)i;
+    }
+    for (size_t i = 0; i < n; ++i) {
+        for (const Arc& arc : g.neighbors(ids[i])) {
+            int j = column[arc.to];
+            if (j < 0 || arc.weight >= dist[i * stride + j]) continue;
+            dist[i * stride + j] = arc.weight;
+            if (withNextHop) next[i * stride + j] = j;
+        }
+    }
+
+    phases.mark("search");
+    BlockKernel product = kernel().product;
+    auto at = [&](size_t bi, size_t bj) { return dist.data() + bi * BLOCK * stride + bj * BLOCK; };
+    auto hopsAt = [&](size_t bi, size_t bj) {
+        return withNextHop ? next.data() + bi * BLOCK * stride + bj * BLOCK : nullptr;
+    };
+    size_t others = blocks > 0 ? blocks - 1 : 0;
+    for (size_t kb = 0; kb < blocks; ++kb) {
+        int* diag = at(kb, kb);
+        int* diagHops = hopsAt(kb, kb);
+        closeBlock(diag, diagHops, stride);
+
+        pool.parallelFor(2 * others, [&](size_t task) {
+            size_t other = task / 2 < kb ? task / 2 : task / 2 + 1;
+            if (task % 2 == 0) {
+                product(at(kb, other), hopsAt(kb, other), diag, diagHops, at(kb, other), stride);
+            } else {
+                product(at(other, kb), hopsAt(other, kb), at(other, kb), hopsAt(other, kb), diag, stride);
+            }
+        });
+
+        pool.parallelFor(others * others, [&](size_t task) {
+            size_t bi = task / others, bj = task % others;
+            if (bi >= kb) bi++;
+            if (bj >= kb) bj++;
+            product(at(bi, bj), hopsAt(bi, bj), at(bi, kb), hopsAt(bi, kb), at(kb, bj), stride);
+        });
+    }
+
+    phases.mark("path");
+    res.cities.reserve(n);
+    for (int id : ids) res.cities.emplace_back(g.nameOf(id));
+    res.distances.resize(n * n);
+    if (withNextHop) res.nextHop.resize(n * n);
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = 0; j < n; ++j) {
+            int d = dist[i * stride + j];
+            res.distances[i * n + j] = d >= FAR ? -1 : d;
+            if (withNextHop) res.nextHop[i * n + j] = d >= FAR ? -1 : next[i * stride + j];
+        }
+    }
+
+    res.found = true;
+    res.message = "Computed a " + to_string(n) + " x " + to_string(n) + " distance matrix (" +
+                  kernelName() + " kernel).";
+    return res;
+}
+
+vector<string> AllPairs::path(const DistanceMatrixResult& matrix, int i, int j) {
+    int n = (int)matrix.cities.size();
+    vector<string> cities;
+    if (matrix.nextHop.empty() || i < 0 || j < 0 || i >= n || j >= n) return cities;
+    if (matrix.distances[(size_t)i * n + j] < 0) return cities;
+
+    cities.push_back(matrix.cities[i]);
+    while (i != j && (int)cities.size() <= n) {
+        i = matrix.nextHop[(size_t)i * n + j];
+        cities.push_back(matrix.cities[i]);
+    }
+    return cities;
+}
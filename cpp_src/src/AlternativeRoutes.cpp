@@ -0,0 +1,186 @@
+#include "../include/AlternativeRoutes.h"
+#include "../include/QueryWorkspace.h"
+#include <algorithm>
+#include <cmath>
+#include <unordered_set>
+
+namespace {
+
+struct Plateau {
+    int first;    // city where the plateau leaves the forward tree path
+    int distance; // of the whole route
+    int length;   // of the plateau
+};
+
+// Dijkstra from source over every city within limit, settled cities marked
+// visited and listed in ws.frontier. If target is given, the limit becomes
+// stretch times its distance once it is settled. Returns the final limit.
+long long growTree(const Graph& g, QueryWorkspace& ws, int source, long long limit, int target,
+                   double stretch, StatsProbe& probe) {
+    ws.reach(source, 0, -1);
+    ws.heap.push(0, source);
+    probe.pushed();
+    while (!ws.heap.empty()) {
+        IdNode top = ws.heap.pop();
+        probe.popped();
+        if (top.weight > ws.dist(top.id)) {
+            probe.stale();
+            continue;
+        }
+        if (top.weight > limit) break;
+        ws.visit(top.id);
+        ws.frontier.push_back(top.id);
+        probe.settled();
+        if (top.id == target) limit = (long long)floor(stretch * top.weight);
+
+        for (const Arc& arc : g.neighbors(top.id)) {
+            probe.relaxed();
+            int newDist = top.weight + arc.weight;
+            if (newDist <= limit && newDist < ws.dist(arc.to)) {
+                ws.reach(arc.to, newDist, top.id);
+                ws.heap.push(newDist, arc.to);
+                probe.pushed();
+                probe.frontier(ws.heap.size());
+            }
+        }
+    }
+    return limit;
+}
+
+uint64_t routeKey(int a, int b) {
+    return (uint64_t)(uint32_t)min(a, b) << 32 | (uint32_t)max(a, b);
+}
+
+} // namespace
+
+bool AlternativeRoutes::validLimits(int maxRoutes, double maxStretch, double maxOverlap,
+                                    double minLocalOptimality) {
+    return maxRoutes >= 1 && maxStretch >= 1.0 && maxStretch <= 100.0 &&
+           maxOverlap >= 0.0 && maxOverlap <= 1.0 &&
+           minLocalOptimality >= 0.0 && minLocalOptimality <= 1.0; // NaN fails every test
+}
+
+PathListResult AlternativeRoutes::find(Graph& g, string start, string end, int maxRoutes,
+                                       double maxStretch, double maxOverlap, double minLocalOptimality,
+                                       SearchStats* stats) {
+    PathListResult res;
+    res.found = false;
+
+    StatsProbe probe(stats);
+    PhaseTimer phases(stats);
+    phases.mark("resolve");
+
+    if (!validLimits(maxRoutes, maxStretch, maxOverlap, minLocalOptimality)) {
+        res.message = "Invalid alternative route limits.";
+        return res;
+    }
+    if (!g.hasNode(start) || !g.hasNode(end)) {
+        res.message = "One or both cities not found in the network.";
+        return res;
+    }
+
+    int source = g.findCity(start);
+    int target = g.findCity(end);
+
+    phases.mark("workspace");
+    QueryWorkspace& forward = QueryWorkspace::acquire(g.idCount(), 0);
+    QueryWorkspace& backward = QueryWorkspace::acquire(g.idCount(), 1);
+
+    // The forward tree grows past the destination up to the stretch
+    // limit, which is only known once the destination is settled
+    phases.mark("forward");
+    long long limit = growTree(g, forward, source, INT_MAX, target, maxStretch, probe);
+    if (!forward.visited(target)) {
+        res.message = "No route exists between these cities.";
+        return res;
+    }
+    int shortest = forward.dist(target);
+
+    phases.mark("backward");
+    growTree(g, backward, target, limit, -1, 1.0, probe);
+
+    // A plateau starts at a city whose backward parent is also its forward
+    // child, unless its own forward parent already continues the chain
+    phases.mark("plateaus");
+    double minPlateau = minLocalOptimality * shortest;
+    vector<Plateau> plateaus;
+    for (int a : forward.frontier) {
+        if (!backward.visited(a) || a == target) continue;
+        int next = backward.parentOf(a);
+        if (!forward.visited(next) || forward.parentOf(next) != a) continue;
+        int prev = forward.parentOf(a);
+        if (prev != -1 && backward.visited(prev) && backward.parentOf(prev) == a) continue;
+
+        int b = a;
+        for (int n = next; n != -1 && forward.visited(n) && forward.parentOf(n) == b; n = backward.parentOf(b)) {
+            b = n;
+        }
+        int distance = forward.dist(a) + backward.dist(a);
+        int length = forward.dist(b) - forward.dist(a);
+        if (distance <= limit && length >= minPlateau) plateaus.push_back({a, distance, length});
+    }
+    sort(plateaus.begin(), plateaus.end(), [](const Plateau& x, const Plateau& y) {
+        if (x.distance - x.length != y.distance - y.length) return x.distance - x.length < y.distance - y.length;
+        return x.first < y.first;
+    });
+
+    phases.mark("path");
+    vector<int> route;
+    auto forwardPath = [&](int a) {
+        route.clear();
+        for (int x = a; x != -1; x = forward.parentOf(x)) route.push_back(x);
+        reverse(route.begin(), route.end());
+    };
+
+    unordered_set<uint64_t> used; // routes of every kept path
+    auto keep = [&](int distance) {
+        ShortestPathResult path;
+        path.found = true;
+        path.distance = distance;
+        for (size_t i = 0; i < route.size(); ++i) {
+            path.path.emplace_back(g.nameOf(route[i]));
+            if (i > 0) used.insert(routeKey(route[i - 1], route[i]));
+        }
+        res.paths.push_back(move(path));
+    };
+
+    forwardPath(target);
+    keep(shortest);
+
+    vector<int> sorted;
+    for (const Plateau& plateau : plateaus) {
+        if ((int)res.paths.size() == maxRoutes) break;
+
+        // Forward tree path to the plateau, then the backward tree path on
+        forwardPath(plateau.first);
+        for (int x = backward.parentOf(plateau.first); x != -1; x = backward.parentOf(x)) route.push_back(x);
+
+        long long shared = 0;
+        for (size_t i = 1; i < route.size(); ++i) {
+            if (!used.count(routeKey(route[i - 1], route[i]))) continue;
+            // Each route lies on one of the two trees, which gives its length
+            int a = route[i - 1], b = route[i];
+            shared += forward.visited(b) && forward.parentOf(b) == a ? forward.dist(b) - forward.dist(a)
+                                                                     : backward.dist(a) - backward.dist(b);
+        }
+        if (shared > maxOverlap * shortest) continue;
+
+        sorted = route;
+        sort(sorted.begin(), sorted.end());
+        if (adjacent_find(sorted.begin(), sorted.end()) != sorted.end()) continue; // not loopless
+
+        keep(plateau.distance);
+    }
+
+    // Kept in order of quality; listed shortest first
+    stable_sort(res.paths.begin() + 1, res.paths.end(),
+         [](const ShortestPathResult& x, const ShortestPathResult& y) { return x.distance < y.distance; });
+    res.paths[0].message = "Shortest path.";
+    for (size_t i = 1; i < res.paths.size(); ++i) res.paths[i].message = "Alternative " + to_string(i) + ".";
+
+    res.found = true;
+    res.message = res.paths.size() == 1
+        ? "No alternative route passes the quality filters."
+        : "Found " + to_string(res.paths.size() - 1) + " alternative routes.";
+    return res;
+}
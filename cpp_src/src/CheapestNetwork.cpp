@@ -1,11 +1,15 @@
 #include "../include/CheapestNetwork.h"
 #include <algorithm>
 
-MSTResult CheapestNetwork::find(Graph& g) {
+MSTResult CheapestNetwork::find(Graph& g, SearchStats* stats) {
     MSTResult res;
     res.found = false;
     res.totalCost = 0;
 
+    StatsProbe probe(stats);
+    PhaseTimer phases(stats);
+    phases.mark("collect");
+
     auto nodes = g.getNodes();
     if (nodes.empty()) {
         res.message = "Graph is empty.";
@@ -14,6 +18,7 @@ MSTResult CheapestNetwork::find(Graph& g) {
 
     // Get all edges and sort by weight (Kruskal's algorithm)
     auto edges = g.getAllEdges();
+    phases.mark("sort");
     sort(edges.begin(), edges.end());
 
     // Use DisjointSet for cycle detection
@@ -22,8 +27,10 @@ MSTResult CheapestNetwork::find(Graph& g) {
         ds.makeSet(node);
     }
 
+    phases.mark("union");
     int edgeCount = 0;
     for (const auto& edge : edges) {
+        probe.relaxed();
         int weight = get<0>(edge);
         string u = get<1>(edge);
         string v = get<2>(edge);
@@ -31,6 +38,7 @@ MSTResult CheapestNetwork::find(Graph& g) {
         // If cities are in different sets, adding this edge won't create a cycle
         if (ds.find(u) != ds.find(v)) {
             ds.unite(u, v);
+            probe.settled();
             res.edges.push_back(make_tuple(u, v, weight));
             res.totalCost += weight;
             edgeCount++;
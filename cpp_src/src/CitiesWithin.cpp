@@ -0,0 +1,177 @@
+#include "../include/CitiesWithin.h"
+#include "../include/DeltaStepping.h"
+#include "../include/QueryWorkspace.h"
+#include <algorithm>
+
+namespace {
+
+// Dijkstra from source over the cities at most maxDistance away, appended
+// to `out` in settling order (nearest first). hops() counts the stops.
+void boundedDijkstra(const Graph& g, QueryWorkspace& ws, int source, int maxDistance,
+                     vector<CityDistance>& out, StatsProbe& probe) {
+    ws.reach(source, 0, -1);
+    ws.setHops(source, 0);
+    ws.heap.push(0, source);
+    probe.pushed();
+
+    while (!ws.heap.empty()) {
+        IdNode top = ws.heap.pop();
+        probe.popped();
+        if (top.weight > ws.dist(top.id)) {
+            probe.stale();
+            continue;
+        }
+        probe.settled();
+        if (top.id != source) out.push_back({string(g.nameOf(top.id)), top.weight, ws.hops(top.id)});
+
+        for (const Arc& arc : g.neighbors(top.id)) {
+            probe.relaxed();
+            int newDist = top.weight + arc.weight;
+            if (newDist <= maxDistance && newDist < ws.dist(arc.to)) {
+                ws.reach(arc.to, newDist, top.id);
+                ws.setHops(arc.to, ws.hops(top.id) + 1);
+                ws.heap.push(newDist, arc.to);
+                probe.pushed();
+                probe.frontier(ws.heap.size());
+            }
+        }
+    }
+}
+
+} // namespace
+
+CitiesWithinResult CitiesWithin::byDistance(Graph& g, string start, int maxDistance, SearchStats* stats) {
+    CitiesWithinResult res;
+    res.found = false;
+
+    StatsProbe probe(stats);
+    PhaseTimer phases(stats);
+    phases.mark("resolve");
+
+    if (maxDistance < 0) {
+        res.message = "Maximum distance must not be negative.";
+        return res;
+    }
+    if (!g.hasNode(start)) {
+        res.message = "City not found in the network.";
+        return res;
+    }
+
+    phases.mark("workspace");
+    QueryWorkspace& ws = QueryWorkspace::acquire(g.idCount());
+
+    phases.mark("search");
+    boundedDijkstra(g, ws, g.findCity(start), maxDistance, res.cities, probe);
+
+    res.found = true;
+    res.message = "Found " + to_string(res.cities.size()) + " cities within " + to_string(maxDistance) + " km.";
+    return res;
+}
+
+CitiesWithinResult CitiesWithin::byStops(Graph& g, string start, int maxStops, SearchStats* stats) {
+    CitiesWithinResult res;
+    res.found = false;
+
+    StatsProbe probe(stats);
+    PhaseTimer phases(stats);
+    phases.mark("resolve");
+
+    if (maxStops < 0) {
+        res.message = "Maximum stops must not be negative.";
+        return res;
+    }
+    if (!g.hasNode(start)) {
+        res.message = "City not found in the network.";
+        return res;
+    }
+
+    int source = g.findCity(start);
+
+    phases.mark("workspace");
+    QueryWorkspace& ws = QueryWorkspace::acquire(g.idCount());
+
+    // FIFO order settles a whole layer before the next one expands, so
+    // each city's distance is final by the time it is dequeued
+    phases.mark("search");
+    ws.reach(source, 0, -1);
+    ws.setHops(source, 0);
+    ws.frontier.push_back(source);
+    for (size_t head = 0; head < ws.frontier.size(); ++head) {
+        int u = ws.frontier[head];
+        probe.settled();
+        if (ws.hops(u) == maxStops) continue;
+
+        for (const Arc& arc : g.neighbors(u)) {
+            probe.relaxed();
+            int newDist = ws.dist(u) + arc.weight;
+            if (!ws.reached(arc.to)) {
+                ws.reach(arc.to, newDist, u);
+                ws.setHops(arc.to, ws.hops(u) + 1);
+                ws.frontier.push_back(arc.to);
+                probe.frontier(ws.frontier.size() - head);
+            } else if (ws.hops(arc.to) == ws.hops(u) + 1 && newDist < ws.dist(arc.to)) {
+                ws.reach(arc.to, newDist, u);
+            }
+        }
+    }
+
+    phases.mark("path");
+    for (size_t i = 1; i < ws.frontier.size(); ++i) {
+        int id = ws.frontier[i];
+        res.cities.push_back({string(g.nameOf(id)), ws.dist(id), ws.hops(id)});
+    }
+    stable_sort(res.cities.begin(), res.cities.end(), [](const CityDistance& a, const CityDistance& b) {
+        return a.stops != b.stops ? a.stops < b.stops : a.distance < b.distance;
+    });
+
+    res.found = true;
+    res.message = "Found " + to_string(res.cities.size()) + " cities within " + to_string(maxStops) + " stops.";
+    return res;
+}
+
+IsochroneResult CitiesWithin::bands(Graph& g, string start, vector<int> radii, SearchStats* stats,
+                                    ThreadPool* pool) {
+    IsochroneResult res;
+    res.found = false;
+
+    StatsProbe probe(stats);
+    PhaseTimer phases(stats);
+    phases.mark("resolve");
+
+    sort(radii.begin(), radii.end());
+    radii.erase(unique(radii.begin(), radii.end()), radii.end());
+    if (radii.empty() || radii.front() < 0) {
+        res.message = "Radii must be given and not negative.";
+        return res;
+    }
+    if (!g.hasNode(start)) {
+        res.message = "City not found in the network.";
+        return res;
+    }
+
+    vector<CityDistance> cities;
+    if (pool) {
+        phases.mark("search");
+        cities = DeltaStepping::ball(g, g.findCity(start), radii.back(), *pool, stats);
+    } else {
+        phases.mark("workspace");
+        QueryWorkspace& ws = QueryWorkspace::acquire(g.idCount());
+
+        phases.mark("search");
+        boundedDijkstra(g, ws, g.findCity(start), radii.back(), cities, probe);
+    }
+
+    // Cities come nearest first, so each band is one consecutive run
+    phases.mark("path");
+    res.bands.resize(radii.size());
+    size_t band = 0;
+    for (CityDistance& city : cities) {
+        while (city.distance > radii[band]) band++;
+        res.bands[band].push_back(move(city));
+    }
+    res.radii = move(radii);
+
+    res.found = true;
+    res.message = "Found " + to_string(cities.size()) + " cities in " + to_string(res.bands.size()) + " bands.";
+    return res;
+}
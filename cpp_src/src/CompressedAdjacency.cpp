@@ -0,0 +1,219 @@
+#include "../include/CompressedAdjacency.h"
+#include <algorithm>
+#include <array>
+#include <climits>
+#include <cstring>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define COMPRESSED_X86
+#include <immintrin.h>
+#endif
+
+namespace {
+
+// Tail room for the unaligned loads of the decoders
+const size_t GAP_PADDING = 16;
+const size_t WEIGHT_PADDING = 8;
+
+uint32_t zigzag(int64_t v) { return (uint32_t)(((uint64_t)v << 1) ^ (uint64_t)(v >> 63)); }
+int64_t unzigzag(uint32_t v) { return (int64_t)(v >> 1) ^ -(int64_t)(v & 1); }
+
+int lengthOf(uint32_t v) { return v < (1u << 8) ? 1 : v < (1u << 16) ? 2 : v < (1u << 24) ? 3 : 4; }
+
+uint32_t loadGap(const uint8_t* p, int code) {
+    static const uint32_t MASK[4] = {0xff, 0xffff, 0xffffff, 0xffffffff};
+    uint32_t v;
+    memcpy(&v, p, 4);
+    return v & MASK[code];
+}
+
+// Per control byte: bytes the four gaps take, and the shuffle that widens
+// them to four 32-bit lanes
+struct GroupTables {
+    array<uint8_t, 256> length;
+    array<array<uint8_t, 16>, 256> shuffle;
+    GroupTables() {
+        for (int control = 0; control < 256; ++control) {
+            int at = 0;
+            for (int lane = 0; lane < 4; ++lane) {
+                int len = ((control >> (2 * lane)) & 3) + 1;
+                for (int b = 0; b < 4; ++b) shuffle[control][lane * 4 + b] = b < len ? at + b : 0x80;
+                at += len;
+            }
+            length[control] = at;
+        }
+    }
+};
+const GroupTables TABLES;
+
+// Targets of lanes [from, n) of the group under control, each gap added to
+// the target before; returns the end of the gaps read
+const uint8_t* scalarGaps(uint8_t control, const uint8_t* data, int from, int n, int32_t previous,
+                          int32_t* targets) {
+    for (int k = from; k < n; ++k) {
+        int code = (control >> (2 * k)) & 3;
+        previous += (int32_t)loadGap(data, code);
+        data += code + 1;
+        targets[k] = previous;
+    }
+    return data;
+}
+
+// All four targets of a group
+using GroupDecoder = const uint8_t* (*)(uint8_t control, const uint8_t* data, int32_t previous,
+                                        int32_t* targets);
+
+const uint8_t* scalarGroup(uint8_t control, const uint8_t* data, int32_t previous, int32_t* targets) {
+    return scalarGaps(control, data, 0, 4, previous, targets);
+}
+
+#ifdef COMPRESSED_X86
+
+// Widened by one shuffle, then a prefix sum in lanes
+__attribute__((target("ssse3")))
+const uint8_t* ssse3Group(uint8_t control, const uint8_t* data, int32_t previous, int32_t* targets) {
+    __m128i gaps = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)data),
+                                    _mm_loadu_si128((const __m128i*)TABLES.shuffle[control].data()));
+    gaps = _mm_add_epi32(gaps, _mm_slli_si128(gaps, 4));
+    gaps = _mm_add_epi32(gaps, _mm_slli_si128(gaps, 8));
+    _mm_storeu_si128((__m128i*)targets, _mm_add_epi32(gaps, _mm_set1_epi32(previous)));
+    return data + TABLES.length[control];
+}
+
+#endif // COMPRESSED_X86
+
+struct Decoder {
+    GroupDecoder group;
+    const char* name;
+};
+
+const Decoder& decoder() {
+    static const Decoder chosen = [] {
+#ifdef COMPRESSED_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("ssse3")) return Decoder{ssse3Group, "ssse3"};
+#endif
+        return Decoder{scalarGroup, "scalar"};
+    }();
+    return chosen;
+}
+
+} // namespace
+
+CompressedAdjacency::CompressedAdjacency(const vector<vector<Arc>>& lists) {
+    size_t n = lists.size();
+    firstArc.assign(n + 1, 0);
+    firstByte.assign(n + 1, 0);
+
+    int32_t lowest = INT_MAX, highest = INT_MIN;
+    for (size_t id = 0; id < n; ++id) {
+        firstArc[id + 1] = firstArc[id] + lists[id].size();
+        for (const Arc& arc : lists[id]) {
+            lowest = min(lowest, arc.weight);
+            highest = max(highest, arc.weight);
+        }
+    }
+    if (firstArc[n] > 0) {
+        weightBase = lowest;
+        uint32_t range = (uint32_t)((int64_t)highest - lowest);
+        while (weightBits < 32 && (range >> weightBits) != 0) weightBits++;
+    }
+    weights.assign((firstArc[n] * weightBits + 7) / 8 + WEIGHT_PADDING, 0);
+
+    vector<Arc> sorted;
+    for (size_t id = 0; id < n; ++id) {
+        sorted.assign(lists[id].begin(), lists[id].end());
+        sort(sorted.begin(), sorted.end(), [](const Arc& a, const Arc& b) {
+            return a.to != b.to ? a.to < b.to : a.weight < b.weight;
+        });
+
+        size_t controlAt = bytes.size();
+        bytes.resize(controlAt + (sorted.size() + 3) / 4, 0);
+        int64_t previous = (int64_t)id;
+        for (size_t k = 0; k < sorted.size(); ++k) {
+            uint32_t gap = k == 0 ? zigzag(sorted[k].to - previous) : (uint32_t)(sorted[k].to - previous);
+            previous = sorted[k].to;
+            int len = lengthOf(gap);
+            bytes[controlAt + k / 4] |= (uint8_t)((len - 1) << (2 * (k % 4)));
+            for (int b = 0; b < len; ++b) bytes.push_back((uint8_t)(gap >> (8 * b)));
+
+            uint64_t value = (uint32_t)((int64_t)sorted[k].weight - weightBase);
+            uint64_t bit = (firstArc[id] + k) * weightBits, word;
+            memcpy(&word, weights.data() + bit / 8, 8);
+            word |= value << (bit % 8);
+            memcpy(weights.data() + bit / 8, &word, 8);
+        }
+        firstByte[id + 1] = bytes.size();
+    }
+    bytes.resize(bytes.size() + GAP_PADDING, 0);
+    bytes.shrink_to_fit();
+}
+
+ArcRange CompressedAdjacency::arcsOf(int id) const {
+    ArcRange range;
+    range.packed = this;
+    range.id = id;
+    range.count = (uint32_t)degree(id);
+    return range;
+}
+
+ArcIterator::ArcIterator(const CompressedAdjacency* packed, int id) : packed(packed) {
+    control = packed->bytes.data() + packed->firstByte[id];
+    count = (uint32_t)packed->degree(id);
+    data = control + (count + 3) / 4;
+    weightBit = packed->firstArc[id] * packed->weightBits;
+    next = 0;
+    previous = id;
+    at = stop = block;
+    refill();
+}
+
+void ArcIterator::refill() {
+    int n = (int)min<uint32_t>(4, count - next);
+    if (n == 0) return;
+
+    int32_t targets[4];
+    uint8_t groupControl = control[next >> 2];
+    int from = 0;
+    if (next == 0) {
+        // The first gap is relative to the city and may be negative
+        int code = groupControl & 3;
+        targets[0] = (int32_t)(previous + unzigzag(loadGap(data, code)));
+        previous = targets[0];
+        data += code + 1;
+        from = 1;
+    }
+    if (from == 0 && n == 4) data = decoder().group(groupControl, data, previous, targets);
+    else data = scalarGaps(groupControl, data, from, n, previous, targets);
+    previous = targets[n - 1];
+
+    int bits = packed->weightBits;
+    uint64_t mask = (1ull << bits) - 1;
+    for (int k = 0; k < n; ++k, weightBit += bits) {
+        uint64_t word;
+        memcpy(&word, packed->weights.data() + weightBit / 8, 8);
+        block[k].to = targets[k];
+        block[k].weight = (int32_t)(packed->weightBase + (int64_t)((word >> (weightBit % 8)) & mask));
+    }
+    next += n;
+    at = block;
+    stop = block + n;
+}
+
+size_t CompressedAdjacency::memoryBytes() const {
+    return (firstArc.capacity() + firstByte.capacity()) * sizeof(uint64_t) + bytes.capacity() +
+           weights.capacity();
+}
+
+size_t CompressedAdjacency::listBytes(const vector<vector<Arc>>& lists) {
+    // As glibc malloc rounds a block: its size plus an 8-byte header, to 16
+    size_t total = lists.capacity() * sizeof(vector<Arc>);
+    for (const auto& arcs : lists) {
+        if (arcs.capacity() > 0) total += (arcs.capacity() * sizeof(Arc) + 8 + 15) / 16 * 16;
+    }
+    return total;
+}
+
+const char* CompressedAdjacency::decoderName() {
+    return decoder().name;
+}
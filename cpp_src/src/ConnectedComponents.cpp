@@ -0,0 +1,136 @@
+#include "../include/ConnectedComponents.h"
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <random>
+#include <unordered_map>
+
+namespace {
+
+// Cities handed to one task
+const size_t CHUNK = 4096;
+// Routes per city linked before sampling
+const size_t NEIGHBOR_ROUNDS = 2;
+// Cities sampled to find the largest component
+const int SAMPLES = 1024;
+
+using Parents = unique_ptr<atomic<int>[]>;
+
+// Hooks the higher root under the lower one; retries from the new roots
+// when another task got there first
+void link(Parents& parent, int u, int v) {
+    int p1 = parent[u].load(memory_order_relaxed);
+    int p2 = parent[v].load(memory_order_relaxed);
+    while (p1 != p2) {
+        int high = max(p1, p2), low = min(p1, p2);
+        int pHigh = parent[high].load(memory_order_relaxed);
+        if (pHigh == low) return;
+        if (pHigh == high && parent[high].compare_exchange_strong(pHigh, low, memory_order_relaxed)) return;
+        p1 = parent[parent[high].load(memory_order_relaxed)].load(memory_order_relaxed);
+        p2 = parent[low].load(memory_order_relaxed);
+    }
+}
+
+} // namespace
+
+ComponentsResult ConnectedComponents::label(const Graph& g, ThreadPool& pool, SearchStats* stats) {
+    ComponentsResult res;
+    res.found = false;
+
+    StatsProbe probe(stats);
+    PhaseTimer phases(stats);
+    phases.mark("workspace");
+    int n = g.idCount();
+    size_t tasks = (n + CHUNK - 1) / CHUNK;
+    Parents parent(new atomic<int>[n]);
+    vector<long long> linked(tasks);
+    auto forEachCity = [&](const function<void(int)>& body) {
+        pool.parallelFor(tasks, [&](size_t task) {
+            int last = (int)min<size_t>(n, (task + 1) * CHUNK);
+            for (int id = (int)(task * CHUNK); id < last; ++id) body(id);
+        });
+    };
+    auto compress = [&] {
+        forEachCity([&](int id) {
+            int p = parent[id].load(memory_order_relaxed);
+            while (p != parent[p].load(memory_order_relaxed)) p = parent[p].load(memory_order_relaxed);
+            parent[id].store(p, memory_order_relaxed);
+        });
+    };
+    forEachCity([&](int id) { parent[id].store(id, memory_order_relaxed); });
+
+    phases.mark("search");
+    for (size_t round = 0; round < NEIGHBOR_ROUNDS; ++round) {
+        pool.parallelFor(tasks, [&](size_t task) {
+            int last = (int)min<size_t>(n, (task + 1) * CHUNK);
+            for (int id = (int)(task * CHUNK); id < last; ++id) {
+                ArcIterator arc = g.neighbors(id).begin();
+                for (size_t r = 0; r < round && arc != ArcEnd(); ++r) ++arc;
+                if (arc != ArcEnd()) {
+                    link(parent, id, arc->to);
+                    linked[task]++;
+                }
+            }
+        });
+        compress();
+    }
+
+    // Cities in the sampled component skip their remaining routes: a route
+    // leaving it is linked from its other end
+    int largest = 0;
+    if (n > 0) {
+        mt19937 rng(n);
+        unordered_map<int, int> seen;
+        int best = 0;
+        for (int s = 0; s < SAMPLES; ++s) {
+            int root = parent[rng() % n].load(memory_order_relaxed);
+            if (++seen[root] > best) {
+                best = seen[root];
+                largest = root;
+            }
+        }
+    }
+    pool.parallelFor(tasks, [&](size_t task) {
+        int last = (int)min<size_t>(n, (task + 1) * CHUNK);
+        for (int id = (int)(task * CHUNK); id < last; ++id) {
+            if (parent[id].load(memory_order_relaxed) == largest) continue;
+            size_t r = 0;
+            for (const Arc& arc : g.neighbors(id)) {
+                if (r++ < NEIGHBOR_ROUNDS) continue;
+                link(parent, id, arc.to);
+                linked[task]++;
+            }
+        }
+    });
+    compress();
+
+    // Number the roots largest first
+    phases.mark("path");
+    vector<int32_t> size(n, 0);
+    for (int id = 0; id < n; ++id) {
+        if (g.isCity(id)) size[parent[id].load(memory_order_relaxed)]++;
+    }
+    vector<int> roots;
+    for (int id = 0; id < n; ++id) {
+        if (size[id] > 0) roots.push_back(id);
+    }
+    stable_sort(roots.begin(), roots.end(), [&](int a, int b) { return size[a] > size[b]; });
+    vector<int32_t> number(n, -1);
+    res.sizes.reserve(roots.size());
+    for (int root : roots) {
+        number[root] = (int32_t)res.sizes.size();
+        res.sizes.push_back(size[root]);
+    }
+    res.component.resize(n);
+    forEachCity([&](int id) {
+        res.component[id] = g.isCity(id) ? number[parent[id].load(memory_order_relaxed)] : -1;
+    });
+
+    if (probe.on()) {
+        for (long long count : linked) stats->edgesRelaxed += count;
+        stats->nodesSettled += n;
+    }
+    res.found = true;
+    res.message = "Found " + to_string(res.sizes.size()) + " connected components.";
+    return res;
+}
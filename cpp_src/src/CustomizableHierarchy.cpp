@@ -0,0 +1,380 @@
+#include "../include/CustomizableHierarchy.h"
+#include "../include/QueryWorkspace.h"
+#include <algorithm>
+#include <functional>
+#include <numeric>
+#include <queue>
+
+namespace {
+
+// Parts this small are ranked as they are
+const size_t LEAF_SIZE = 8;
+
+// Nested dissection over the routes; returns the city ids in rank order.
+// A part is first split into its connected components. A connected part is
+// cut at one BFS level from a pseudo-peripheral city: the smallest level
+// leaving at least a quarter of the part on either side, or the middle one.
+// Level cities without a route to the next level drop to the lower half,
+// the rest form the separator, ranked above both halves.
+vector<int> dissect(const Graph& g) {
+    int n = g.idCount();
+    vector<int> order(n);
+    int next = n; // ranks are handed out from the top
+
+    vector<int> part(n, 0);  // token of the part a city is in
+    vector<int> mark(n, 0);  // token of the part that split it off
+    vector<int> seen(n, 0);  // BFS round
+    vector<int> level(n, 0);
+    int token = 0, round = 0;
+    vector<int> queue;
+
+    auto bfs = [&](int from) {
+        round++;
+        queue.clear();
+        queue.push_back(from);
+        seen[from] = round;
+        level[from] = 0;
+        for (size_t i = 0; i < queue.size(); ++i) {
+            int u = queue[i];
+            for (const Arc& arc : g.neighbors(u)) {
+                if (part[arc.to] != token || seen[arc.to] == round) continue;
+                seen[arc.to] = round;
+                level[arc.to] = level[u] + 1;
+                queue.push_back(arc.to);
+            }
+        }
+    };
+
+    vector<vector<int>> parts(1, vector<int>(n));
+    iota(parts[0].begin(), parts[0].end(), 0);
+
+    while (!parts.empty()) {
+        vector<int> members = move(parts.back());
+        parts.pop_back();
+        token++;
+        for (int v : members) part[v] = token;
+
+        if (members.size() <= LEAF_SIZE) {
+            for (int v : members) order[--next] = v;
+            continue;
+        }
+
+        bfs(members[0]);
+        if (queue.size() < members.size()) {
+            for (int v : members) {
+                if (mark[v] == token) continue;
+                bfs(v);
+                for (int u : queue) mark[u] = token;
+                parts.push_back(queue);
+            }
+            continue;
+        }
+
+        bfs(queue.back());
+        int depth = level[queue.back()];
+        if (depth < 2) {
+            for (int v : members) order[--next] = v;
+            continue;
+        }
+
+        vector<size_t> count(depth + 1, 0);
+        for (int v : members) count[level[v]]++;
+        size_t size = members.size();
+        int cut = -1;
+        size_t below = count[0];
+        for (int k = 1; k < depth; ++k) {
+            size_t above = size - below - count[k];
+            if (4 * min(below, above) >= size && (cut < 0 || count[k] < count[cut])) cut = k;
+            below += count[k];
+        }
+        if (cut < 0) {
+            cut = 1;
+            for (below = count[0]; cut < depth - 1 && 2 * (below + count[cut]) < size; ++cut) below += count[cut];
+        }
+
+        vector<int> lower, upper;
+        for (int v : members) {
+            if (level[v] < cut) {
+                lower.push_back(v);
+            } else if (level[v] > cut) {
+                upper.push_back(v);
+            } else {
+                bool leadsUp = false;
+                for (const Arc& arc : g.neighbors(v)) {
+                    if (part[arc.to] == token && level[arc.to] == cut + 1) {
+                        leadsUp = true;
+                        break;
+                    }
+                }
+                if (leadsUp) order[--next] = v;
+                else lower.push_back(v);
+            }
+        }
+        parts.push_back(move(lower));
+        parts.push_back(move(upper));
+    }
+    return order;
+}
+
+} // namespace
+
+CustomizableHierarchy::CustomizableHierarchy(const Graph& g) {
+    cityAt = dissect(g);
+    int n = (int)cityAt.size();
+    rankOf.assign(n, 0);
+    for (int r = 0; r < n; ++r) rankOf[cityAt[r]] = r;
+
+    // Contracting a city joins its upper neighbours into a clique; adding
+    // them to the lowest one (its elimination-tree parent) is enough, as
+    // that one's contraction passes them on
+    vector<vector<int>> up(n);
+    for (int id = 0; id < n; ++id) {
+        for (const Arc& arc : g.neighbors(id)) {
+            if (rankOf[arc.to] > rankOf[id]) up[rankOf[id]].push_back(rankOf[arc.to]);
+        }
+    }
+    parent.assign(n, -1);
+    firstUp.assign(n + 1, 0);
+    for (int r = 0; r < n; ++r) {
+        vector<int>& list = up[r];
+        sort(list.begin(), list.end());
+        list.erase(unique(list.begin(), list.end()), list.end());
+        firstUp[r + 1] = firstUp[r] + (int)list.size();
+        if (list.empty()) continue;
+        parent[r] = list[0];
+        up[list[0]].insert(up[list[0]].end(), list.begin() + 1, list.end());
+    }
+
+    head.reserve(firstUp[n]);
+    tail.reserve(firstUp[n]);
+    for (int r = 0; r < n; ++r) {
+        for (int x : up[r]) {
+            head.push_back(x);
+            tail.push_back(r);
+        }
+        vector<int>().swap(up[r]);
+    }
+
+    vector<int> depth(n, 1);
+    for (int r = n - 1; r >= 0; --r) {
+        if (parent[r] >= 0) depth[r] = depth[parent[r]] + 1;
+        treeHeight = max(treeHeight, depth[r]);
+    }
+
+    firstDown.assign(n + 1, 0);
+    for (int x : head) firstDown[x + 1]++;
+    for (int r = 0; r < n; ++r) firstDown[r + 1] += firstDown[r];
+    downTail.resize(head.size());
+    downArc.resize(head.size());
+    vector<int> fill(firstDown.begin(), firstDown.end() - 1);
+    for (int a = 0; a < (int)head.size(); ++a) {
+        int slot = fill[head[a]]++;
+        downTail[slot] = tail[a];
+        downArc[slot] = a;
+    }
+
+    input.assign(head.size(), UNREACHABLE);
+    for (int id = 0; id < n; ++id) {
+        for (const Arc& arc : g.neighbors(id)) {
+            if (rankOf[arc.to] <= rankOf[id]) continue;
+            int a = findArc(rankOf[id], rankOf[arc.to]);
+            input[a] = min(input[a], arc.weight);
+            routeArcs++;
+        }
+    }
+    queuedStamp.assign(head.size(), 0);
+    customize();
+}
+
+int CustomizableHierarchy::findArc(int a, int b) const {
+    if (a > b) swap(a, b);
+    auto first = head.begin() + firstUp[a], last = head.begin() + firstUp[a + 1];
+    auto it = lower_bound(first, last, b);
+    return it != last && *it == b ? (int)(it - head.begin()) : -1;
+}
+
+int CustomizableHierarchy::viaLower(int arc) const {
+    int v = tail[arc], u = head[arc];
+    int best = UNREACHABLE;
+    int i = firstDown[v], j = firstDown[u];
+    while (i < firstDown[v + 1] && j < firstDown[u + 1]) {
+        if (downTail[i] < downTail[j]) {
+            ++i;
+        } else if (downTail[i] > downTail[j]) {
+            ++j;
+        } else {
+            int toV = metric[downArc[i++]], toU = metric[downArc[j++]];
+            if (toV != UNREACHABLE && toU != UNREACHABLE) best = min(best, toV + toU);
+        }
+    }
+    return best;
+}
+
+// Lower triangles in rank order: when w is reached, its arcs are final and
+// every pair of them bounds the arc between their upper ends
+void CustomizableHierarchy::customize() {
+    metric = input;
+    int n = idCount();
+    for (int w = 0; w < n; ++w) {
+        for (int i = firstUp[w]; i < firstUp[w + 1]; ++i) {
+            int toX = metric[i];
+            if (toX == UNREACHABLE) continue;
+            int k = firstUp[head[i]];
+            for (int j = i + 1; j < firstUp[w + 1]; ++j) {
+                int toY = metric[j];
+                if (toY == UNREACHABLE) continue;
+                while (head[k] != head[j]) ++k; // present, the supergraph is chordal
+                metric[k] = min(metric[k], toX + toY);
+            }
+        }
+    }
+}
+
+// An arc only feeds triangles of arcs with a higher lower end, so taking
+// queued arcs by lower rank settles each one before its dependants
+void CustomizableHierarchy::repair(const vector<int>& arcs) {
+    repairRound++;
+    priority_queue<pair<int, int>, vector<pair<int, int>>, greater<pair<int, int>>> queued;
+    auto enqueue = [&](int a) {
+        if (queuedStamp[a] == repairRound) return;
+        queuedStamp[a] = repairRound;
+        queued.push({tail[a], a});
+    };
+    for (int a : arcs) enqueue(a);
+
+    while (!queued.empty()) {
+        int a = queued.top().second;
+        queued.pop();
+        int value = min(input[a], viaLower(a));
+        if (value == metric[a]) continue;
+        metric[a] = value;
+        for (int i = firstUp[tail[a]]; i < firstUp[tail[a] + 1]; ++i) {
+            if (head[i] != head[a]) enqueue(findArc(head[a], head[i]));
+        }
+    }
+}
+
+bool CustomizableHierarchy::updateWeight(int a, int b, int weight) {
+    return updateWeights({{a, b, weight}});
+}
+
+bool CustomizableHierarchy::updateWeights(const vector<RouteRecord>& routes) {
+    vector<int> arcs;
+    arcs.reserve(routes.size());
+    for (const RouteRecord& route : routes) {
+        if (route.a < 0 || route.b < 0 || route.a >= idCount() || route.b >= idCount()) return false;
+        int a = findArc(rankOf[route.a], rankOf[route.b]);
+        if (a < 0) return false;
+        arcs.push_back(a);
+    }
+    for (size_t i = 0; i < routes.size(); ++i) {
+        input[arcs[i]] = routes[i].weight < 0 ? UNREACHABLE : routes[i].weight;
+    }
+    repair(arcs);
+    return true;
+}
+
+// Appends the ranks after `from` up to `to` on the route path the arc
+// between them stands for
+void CustomizableHierarchy::unpack(int from, int to, vector<int>& ranks) const {
+    vector<pair<int, int>> pending{{from, to}};
+    while (!pending.empty()) {
+        auto [f, t] = pending.back();
+        pending.pop_back();
+        int a = findArc(f, t);
+        if (input[a] == metric[a]) {
+            ranks.push_back(t);
+            continue;
+        }
+        int v = tail[a], u = head[a];
+        int i = firstDown[v], j = firstDown[u];
+        while (true) {
+            if (downTail[i] < downTail[j]) {
+                ++i;
+            } else if (downTail[i] > downTail[j]) {
+                ++j;
+            } else {
+                int toV = metric[downArc[i]], toU = metric[downArc[j]];
+                if (toV != UNREACHABLE && toU != UNREACHABLE && toV + toU == metric[a]) break;
+                ++i;
+                ++j;
+            }
+        }
+        int w = downTail[i];
+        pending.push_back({w, t});
+        pending.push_back({f, w});
+    }
+}
+
+ShortestPathResult CustomizableHierarchy::query(Graph& g, const string& start, const string& end,
+                                                SearchStats* stats) const {
+    ShortestPathResult res;
+    res.found = false;
+    res.distance = 0;
+
+    StatsProbe probe(stats);
+    PhaseTimer phases(stats);
+    phases.mark("resolve");
+
+    if (!g.hasNode(start) || !g.hasNode(end)) {
+        res.message = "One or both cities not found in the network.";
+        return res;
+    }
+
+    // Cities added since the build have no rank; callers rebuild first
+    int source = rankOf[g.findCity(start)];
+    int target = rankOf[g.findCity(end)];
+
+    phases.mark("workspace");
+    QueryWorkspace& forward = QueryWorkspace::acquire(idCount(), 0);
+    QueryWorkspace& backward = QueryWorkspace::acquire(idCount(), 1);
+
+    // Every upward arc leads to an ancestor, so relaxing along the tree
+    // path visits each city after all its predecessors
+    phases.mark("search");
+    auto climb = [&](QueryWorkspace& ws, int from) {
+        ws.reach(from, 0, -1);
+        for (int v = from; v >= 0; v = parent[v]) {
+            if (!ws.reached(v)) continue;
+            probe.settled();
+            for (int a = firstUp[v]; a < firstUp[v + 1]; ++a) {
+                probe.relaxed();
+                if (metric[a] == UNREACHABLE) continue;
+                int newDist = ws.dist(v) + metric[a];
+                if (newDist < ws.dist(head[a])) ws.reach(head[a], newDist, v);
+            }
+        }
+    };
+    climb(forward, source);
+    climb(backward, target);
+
+    int meet = -1, best = UNREACHABLE;
+    for (int v = target; v >= 0; v = parent[v]) {
+        if (!forward.reached(v) || !backward.reached(v)) continue;
+        int total = forward.dist(v) + backward.dist(v);
+        if (total < best) {
+            best = total;
+            meet = v;
+        }
+    }
+
+    phases.mark("path");
+    if (meet < 0) {
+        res.message = "No route exists between these cities.";
+        return res;
+    }
+
+    vector<int> hierarchyPath;
+    for (int v = meet; v >= 0; v = forward.parentOf(v)) hierarchyPath.push_back(v);
+    reverse(hierarchyPath.begin(), hierarchyPath.end());
+    for (int v = backward.parentOf(meet); v >= 0; v = backward.parentOf(v)) hierarchyPath.push_back(v);
+
+    vector<int> ranks{source};
+    for (size_t i = 1; i < hierarchyPath.size(); ++i) unpack(hierarchyPath[i - 1], hierarchyPath[i], ranks);
+    for (int r : ranks) res.path.emplace_back(g.nameOf(cityAt[r]));
+
+    res.found = true;
+    res.distance = best;
+    res.message = "Shortest path found successfully.";
+    return res;
+}
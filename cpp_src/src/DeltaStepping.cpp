@@ -0,0 +1,242 @@
+#include "../include/DeltaStepping.h"
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <memory>
+
+namespace {
+
+// Frontier cities handed to one task
+const size_t CHUNK = 512;
+// Routes sampled by autoDelta
+const int DELTA_SAMPLE = 4096;
+
+// Distance in the high half, parent in the low half; unset reads as the
+// largest distance
+const uint64_t UNSET = ~0ull;
+
+uint64_t pack(int distance, int parent) {
+    return (uint64_t)(uint32_t)distance << 32 | (uint32_t)parent;
+}
+int distanceOf(uint64_t label) { return (int)(label >> 32); }
+int parentOf(uint64_t label) { return (int)(uint32_t)label; }
+
+// Cities one task improved, and its share of the counters
+struct TaskOutput {
+    vector<int> improved;
+    long long relaxed = 0;
+};
+
+} // namespace
+
+int DeltaStepping::autoDelta(const Graph& g) {
+    int n = g.idCount();
+    long long total = 0, routes = 0;
+    int step = max(1, n / DELTA_SAMPLE);
+    for (int id = 0; id < n && routes < DELTA_SAMPLE; id += step) {
+        for (const Arc& arc : g.neighbors(id)) {
+            total += arc.weight;
+            routes++;
+        }
+    }
+    return routes > 0 ? max<long long>(1, total / routes) : 1;
+}
+
+vector<SettledCity> DeltaStepping::run(const Graph& g, int source, int maxDistance, int delta,
+                                       ThreadPool& pool, SearchStats* stats) {
+    StatsProbe probe(stats);
+    if (delta <= 0) delta = autoDelta(g);
+    int n = g.idCount();
+
+    // queuedIn: bucket a city waits in (other entries for it are stale);
+    // settledIn: bucket that listed it for its heavy routes
+    unique_ptr<atomic<uint64_t>[]> label(new atomic<uint64_t>[n]);
+    vector<int> queuedIn(n), settledIn(n);
+    pool.parallelFor((n + CHUNK * 16 - 1) / (CHUNK * 16), [&](size_t task) {
+        size_t last = min<size_t>(n, (task + 1) * CHUNK * 16);
+        for (size_t id = task * CHUNK * 16; id < last; ++id) {
+            label[id].store(UNSET, memory_order_relaxed);
+            queuedIn[id] = -1;
+            settledIn[id] = -1;
+        }
+    });
+
+    auto improve = [&](int v, long long d, int from) {
+        if (d > maxDistance) return false;
+        uint64_t current = label[v].load(memory_order_relaxed);
+        while ((current >> 32) > (uint64_t)d) {
+            if (label[v].compare_exchange_weak(current, pack((int)d, from), memory_order_relaxed)) return true;
+        }
+        return false;
+    };
+    auto dist = [&](int v) { return distanceOf(label[v].load(memory_order_relaxed)); };
+
+    // Relaxes the light or heavy routes of `from` across the pool
+    vector<TaskOutput> outputs;
+    auto relax = [&](const vector<int>& from, bool light) {
+        size_t tasks = (from.size() + CHUNK - 1) / CHUNK;
+        if (outputs.size() < tasks) outputs.resize(tasks);
+        pool.parallelFor(tasks, [&](size_t task) {
+            TaskOutput& out = outputs[task];
+            out.improved.clear();
+            out.relaxed = 0;
+            size_t last = min(from.size(), (task + 1) * CHUNK);
+            for (size_t i = task * CHUNK; i < last; ++i) {
+                int u = from[i];
+                long long du = dist(u);
+                for (const Arc& arc : g.neighbors(u)) {
+                    if ((arc.weight <= delta) != light) continue;
+                    out.relaxed++;
+                    if (improve(arc.to, du + arc.weight, u)) out.improved.push_back(arc.to);
+                }
+            }
+        });
+        return tasks;
+    };
+
+    map<int, vector<int>> buckets;
+    // Files the cities the last relax() improved; those landing in bucket
+    // `key` go to `again` instead
+    auto file = [&](size_t tasks, int key, vector<int>& again) {
+        for (size_t t = 0; t < tasks; ++t) {
+            if (probe.on()) stats->edgesRelaxed += outputs[t].relaxed;
+            for (int v : outputs[t].improved) {
+                int b = dist(v) / delta;
+                if (queuedIn[v] == b) continue;
+                queuedIn[v] = b;
+                if (b == key) again.push_back(v);
+                else buckets[b].push_back(v);
+                probe.pushed();
+            }
+        }
+    };
+
+    vector<SettledCity> settled;
+    improve(source, 0, -1);
+    queuedIn[source] = 0;
+    buckets[0].push_back(source);
+
+    vector<int> current, frontier, heavy;
+    while (!buckets.empty()) {
+        int key = buckets.begin()->first;
+        current = move(buckets.begin()->second);
+        buckets.erase(buckets.begin());
+        heavy.clear();
+
+        while (!current.empty()) {
+            frontier.clear();
+            for (int v : current) {
+                probe.popped();
+                if (queuedIn[v] != key) {
+                    probe.stale();
+                    continue;
+                }
+                queuedIn[v] = -1;
+                frontier.push_back(v);
+                if (settledIn[v] != key) {
+                    settledIn[v] = key;
+                    heavy.push_back(v);
+                }
+            }
+            probe.frontier(frontier.size());
+            current.clear();
+            file(relax(frontier, true), key, current);
+        }
+
+        // The bucket is final: its heavy routes only reach later buckets
+        file(relax(heavy, false), key, current);
+        for (int v : heavy) {
+            uint64_t l = label[v].load(memory_order_relaxed);
+            settled.push_back({v, distanceOf(l), parentOf(l)});
+            probe.settled();
+        }
+    }
+    return settled;
+}
+
+vector<CityDistance> DeltaStepping::ball(const Graph& g, int source, int maxDistance, ThreadPool& pool,
+                                         SearchStats* stats) {
+    vector<SettledCity> settled = run(g, source, maxDistance, 0, pool, stats);
+    sort(settled.begin(), settled.end(), [](const SettledCity& a, const SettledCity& b) {
+        return a.distance != b.distance ? a.distance < b.distance : a.id < b.id;
+    });
+
+    // A parent is strictly nearer, so it comes first
+    vector<int> stops(g.idCount());
+    vector<CityDistance> cities;
+    cities.reserve(settled.size());
+    for (const SettledCity& city : settled) {
+        if (city.parent < 0) {
+            stops[city.id] = 0;
+            continue;
+        }
+        stops[city.id] = stops[city.parent] + 1;
+        cities.push_back({string(g.nameOf(city.id)), city.distance, stops[city.id]});
+    }
+    return cities;
+}
+
+CitiesWithinResult DeltaStepping::allFrom(Graph& g, string start, ThreadPool& pool, SearchStats* stats) {
+    CitiesWithinResult res;
+    res.found = false;
+
+    PhaseTimer phases(stats);
+    phases.mark("resolve");
+    if (!g.hasNode(start)) {
+        res.message = "City not found in the network.";
+        return res;
+    }
+
+    phases.mark("search");
+    res.cities = ball(g, g.findCity(start), INT_MAX, pool, stats);
+
+    res.found = true;
+    res.message = "Found " + to_string(res.cities.size()) + " reachable cities.";
+    return res;
+}
+
+DistanceTableResult DeltaStepping::table(Graph& g, const vector<string>& sources, const vector<string>& targets,
+                                         ThreadPool& pool, SearchStats* stats) {
+    DistanceTableResult res;
+    res.found = false;
+
+    PhaseTimer phases(stats);
+    phases.mark("resolve");
+    if (sources.empty() || targets.empty()) {
+        res.message = "Sources and targets must not be empty.";
+        return res;
+    }
+    for (const vector<string>* list : {&sources, &targets}) {
+        for (const string& name : *list) {
+            if (!g.hasNode(name)) {
+                res.message = "City not found in the network: " + name;
+                return res;
+            }
+        }
+    }
+
+    // Columns of each target city, as linked lists (a city may repeat)
+    vector<int> firstColumn(g.idCount(), -1), nextColumn(targets.size());
+    for (size_t j = 0; j < targets.size(); ++j) {
+        int id = g.findCity(targets[j]);
+        nextColumn[j] = firstColumn[id];
+        firstColumn[id] = (int)j;
+    }
+
+    phases.mark("search");
+    int delta = autoDelta(g);
+    res.distances.assign(sources.size() * targets.size(), -1);
+    for (size_t i = 0; i < sources.size(); ++i) {
+        int* row = res.distances.data() + i * targets.size();
+        for (const SettledCity& city : run(g, g.findCity(sources[i]), INT_MAX, delta, pool, stats)) {
+            for (int j = firstColumn[city.id]; j >= 0; j = nextColumn[j]) row[j] = city.distance;
+        }
+    }
+
+    res.sources = sources;
+    res.targets = targets;
+    res.found = true;
+    res.message = "Computed a " + to_string(sources.size()) + " x " + to_string(targets.size()) +
+                  " distance table.";
+    return res;
+}
@@ -1,64 +1,52 @@
 #include "../include/FewestStops.h"
-#include <map>
+#include "../include/QueryWorkspace.h"
 
-FewestStopsResult FewestStops::find(Graph& g, string start, string end) {
+FewestStopsResult FewestStops::find(Graph& g, string start, string end, SearchStats* stats) {
     FewestStopsResult res;
     res.found = false;
     res.stops = 0;
 
-    // Check if cities exist
-    auto nodes = g.getNodes();
-    bool startExists = false, endExists = false;
-    for (const auto& n : nodes) {
-        if (n == start) startExists = true;
-        if (n == end) endExists = true;
-    }
+    StatsProbe probe(stats);
+    PhaseTimer phases(stats);
+    phases.mark("resolve");
 
-    if (!startExists || !endExists) {
+    // Check if cities exist
+    if (!g.hasNode(start) || !g.hasNode(end)) {
         res.message = "One or both cities not found in the network.";
         return res;
     }
 
-    map<string, bool> visited;
-    map<string, string> parent;
-    CustomQueue<string> q;
+    int source = g.findCity(start);
+    int target = g.findCity(end);
+
+    phases.mark("workspace");
+    // BFS; frontier is the queue, reached() doubles as the visited set
+    QueryWorkspace& ws = QueryWorkspace::acquire(g.idCount());
+    ws.frontier.push_back(source);
+    ws.reach(source, 0, -1);
 
-    q.enqueue(start);
-    visited[start] = true;
+    phases.mark("search");
+    for (size_t head = 0; head < ws.frontier.size(); ++head) {
+        int u = ws.frontier[head];
+        probe.settled();
 
-    while (!q.empty()) {
-        string u = q.front(); 
-        q.dequeue();
-        
-        if (u == end) {
+        if (u == target) {
+            phases.mark("path");
             res.found = true;
             res.message = "Path found with fewest stops.";
-            
-            // Reconstruct path using CustomStack
-            CustomStack<string> pathStack;
-            string curr = end;
-            while (curr != start) {
-                pathStack.push(curr);
-                curr = parent[curr];
-            }
-            pathStack.push(start);
-
-            while (!pathStack.empty()) {
-                res.path.push_back(pathStack.top());
-                pathStack.pop();
-            }
-            
+            res.path = ws.pathTo(g, target);
             res.stops = res.path.size() - 1;
             return res;
         }
 
-        for (const auto& e : g.getNeighbors(u)) {
-            if (!visited[e.dest]) {
-                visited[e.dest] = true;
-                parent[e.dest] = u;
-                q.enqueue(e.dest);
+        for (const Arc& arc : g.neighbors(u)) {
+            probe.relaxed();
+            if (!ws.reached(arc.to)) {
+                ws.reach(arc.to, ws.dist(u) + 1, u);
+                ws.frontier.push_back(arc.to);
             }
         }
+        probe.frontier(ws.frontier.size() - head - 1);
     }
 
     res.message = "No path exists between these cities.";
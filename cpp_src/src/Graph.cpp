@@ -1,139 +1,420 @@
 #include "../include/Graph.h"
 #include <algorithm>
 
-string toLower(string s) {
-    transform(s.begin(), s.end(), s.begin(), ::tolower);
-    return s;
+int Graph::lookup(string_view name) const {
+    if (snapshot) return snapshot->lookup(name);
+    return ids.find(name, names);
 }
 
-void Graph::addEdge(string u, string v, int w) {
-    string lu = toLower(u);
-    string lv = toLower(v);
-    
-    string keyU = lowerToOriginal.count(lu) ? lowerToOriginal[lu] : u;
-    string keyV = lowerToOriginal.count(lv) ? lowerToOriginal[lv] : v;
-    
-    lowerToOriginal[lu] = keyU;
-    lowerToOriginal[lv] = keyV;
-    
-    if (hasEdge(u, v)) removeEdge(u, v);
-    
-    adjList[keyU].push_back({keyV, w});
-    adjList[keyV].push_back({keyU, w});
+int Graph::intern(const string& name) {
+    uint64_t hash = NameFold::hash(name);
+    int id = ids.find(name, hash, names);
+    if (id != -1) return id;
+
+    id = names.size();
+    names.push_back(name);
+    adj.emplace_back();
+    ids.insert(id, hash, names);
+    return id;
 }
 
-bool Graph::updateEdge(string u, string v, int w) {
-    string lu = toLower(u);
-    string lv = toLower(v);
-    
-    if (!lowerToOriginal.count(lu) || !lowerToOriginal.count(lv)) return false;
-    
-    string keyU = lowerToOriginal[lu];
-    string keyV = lowerToOriginal[lv];
-    
-    if (!hasEdge(u, v)) return false;
-    
-    // Update weight in u's list
-    for (auto& edge : adjList[keyU]) {
-        if (edge.dest == keyV) {
-            edge.weight = w;
-            break;
+void Graph::thaw() {
+    if (packed) {
+        adj.resize(packed->idCount());
+        for (int id = 0; id < packed->idCount(); ++id) {
+            adj[id].reserve(packed->degree(id));
+            for (const Arc& arc : packed->arcsOf(id)) adj[id].push_back(arc);
         }
+        packed.reset();
+        return;
     }
-    
-    // Update weight in v's list
-    for (auto& edge : adjList[keyV]) {
-        if (edge.dest == keyU) {
-            edge.weight = w;
-            break;
-        }
+    if (!snapshot) return;
+
+    int n = snapshot->idCount();
+    names.reserve(n);
+    adj.resize(n);
+    for (int id = 0; id < n; ++id) {
+        names.emplace_back(snapshot->nameOf(id));
     }
-    return true;
+    ids.reserve(n, names);
+    for (int id = 0; id < n; ++id) {
+        ids.insert(id, NameFold::hash(names[id]), names);
+        ArcRange arcs = snapshot->arcsOf(id);
+        adj[id].assign(arcs.first, arcs.last);
+    }
+    cityCount = snapshot->getCityCount();
+    routeCount = snapshot->getRouteCount();
+    snapshot.reset();
 }
 
-void Graph::removeEdge(string u, string v) {
-    string lu = toLower(u);
-    string lv = toLower(v);
-    
-    if (!lowerToOriginal.count(lu) || !lowerToOriginal.count(lv)) return;
-    
-    string keyU = lowerToOriginal[lu];
-    string keyV = lowerToOriginal[lv];
-    
-    if (adjList.count(keyU)) {
-        auto& edges = adjList[keyU];
-        for (auto it = edges.begin(); it != edges.end(); ) {
-            if (it->dest == keyV) it = edges.erase(it);
-            else ++it;
-        }
-        if (edges.empty()) {
-            adjList.erase(keyU);
+void Graph::eraseArc(int from, int to) {
+    auto& arcs = adj[from];
+    arcs.erase(remove_if(arcs.begin(), arcs.end(),
+                         [to](const Arc& a) { return a.to == to; }),
+               arcs.end());
+}
+
+void Graph::addEdge(string u, string v, int w) {
+    thaw();
+    link(intern(u), intern(v), w);
+}
+
+void Graph::link(int a, int b, int w) {
+    // Existing route: overwrite in place instead of remove + re-add
+    bool exists = false;
+    for (auto& arc : adj[a]) {
+        if (arc.to == b) {
+            arc.weight = w;
+            exists = true;
         }
     }
-    if (adjList.count(keyV)) {
-        auto& edges = adjList[keyV];
-        for (auto it = edges.begin(); it != edges.end(); ) {
-            if (it->dest == keyU) it = edges.erase(it);
-            else ++it;
-        }
-        if (edges.empty()) {
-            adjList.erase(keyV);
+    if (exists) {
+        for (auto& arc : adj[b]) {
+            if (arc.to == a) arc.weight = w;
         }
+        return;
     }
+
+    if (adj[a].empty()) cityCount++;
+    if (b != a && adj[b].empty()) cityCount++;
+    adj[a].push_back({b, w});
+    adj[b].push_back({a, w});
+    routeCount++;
+}
+
+bool Graph::updateEdge(string u, string v, int w) {
+    if (!hasEdge(u, v)) return false;
+
+    thaw();
+    int a = lookup(u);
+    int b = lookup(v);
+
+    for (auto& arc : adj[a]) {
+        if (arc.to == b) arc.weight = w;
+    }
+    for (auto& arc : adj[b]) {
+        if (arc.to == a) arc.weight = w;
+    }
+    return true;
+}
+
+void Graph::removeEdge(string u, string v) {
+    if (!hasEdge(u, v)) return;
+
+    thaw();
+    int a = lookup(u);
+    int b = lookup(v);
+
+    eraseArc(a, b);
+    if (b != a) eraseArc(b, a);
+    routeCount--;
+
+    if (adj[a].empty()) cityCount--;
+    if (b != a && adj[b].empty()) cityCount--;
 }
 
 bool Graph::hasEdge(string u, string v) {
-    string lu = toLower(u);
-    string lv = toLower(v);
-    
-    if (!lowerToOriginal.count(lu) || !lowerToOriginal.count(lv)) return false;
-    
-    string keyU = lowerToOriginal[lu];
-    string keyV = lowerToOriginal[lv];
-    
-    if (adjList.find(keyU) == adjList.end()) return false;
-    for (const auto& e : adjList[keyU]) {
-        if (e.dest == keyV) return true;
+    return getEdgeWeight(u, v) != -1;
+}
+
+int Graph::getEdgeWeight(string u, string v) {
+    int a = lookup(u);
+    int b = lookup(v);
+    if (a == -1 || b == -1) return -1;
+
+    for (const auto& arc : neighbors(a)) {
+        if (arc.to == b) return arc.weight;
     }
-    return false;
+    return -1;
+}
+
+bool Graph::hasNode(const string& city) {
+    int id = lookup(city);
+    return id != -1 && isCity(id) && nameOf(id) == city;
+}
+
+string Graph::canonicalName(string city) {
+    int id = lookup(city);
+    if (id == -1) return "";
+    return string(nameOf(id));
 }
 
 vector<Edge> Graph::getNeighbors(string u) {
-    string lu = toLower(u);
-    if (!lowerToOriginal.count(lu)) return {};
-    
-    string keyU = lowerToOriginal[lu];
-    if (adjList.find(keyU) != adjList.end()) return adjList[keyU];
-    return {};
+    int id = lookup(u);
+    if (id == -1) return {};
+
+    vector<Edge> edges;
+    ArcRange arcs = neighbors(id);
+    edges.reserve(arcs.size());
+    for (const auto& arc : arcs) {
+        edges.push_back({string(nameOf(arc.to)), arc.weight});
+    }
+    return edges;
 }
 
 vector<string> Graph::getNodes() {
     vector<string> nodes;
-    for (const auto& pair : adjList) {
-        nodes.push_back(pair.first);
+    nodes.reserve(getCityCount());
+    for (int id = 0; id < idCount(); ++id) {
+        if (isCity(id)) nodes.emplace_back(nameOf(id));
     }
+    sort(nodes.begin(), nodes.end());
     return nodes;
 }
 
 void Graph::clear() {
-    adjList.clear();
-    lowerToOriginal.clear();
+    names.clear();
+    ids.clear();
+    adj.clear();
+    cityCount = 0;
+    routeCount = 0;
+    snapshot.reset();
+    packed.reset();
 }
 
 int Graph::getCityCount() {
-    return adjList.size();
+    return snapshot ? snapshot->getCityCount() : cityCount;
 }
 
 vector<tuple<int, string, string>> Graph::getAllEdges() {
+    vector<int> order;
+    for (int id = 0; id < idCount(); ++id) {
+        if (isCity(id)) order.push_back(id);
+    }
+    sort(order.begin(), order.end(),
+         [this](int a, int b) { return nameOf(a) < nameOf(b); });
+
     vector<tuple<int, string, string>> edges;
-    
-    for (const auto& pair : adjList) {
-        string u = pair.first;
-        for (const auto& e : pair.second) {
-            if (u < e.dest) {
-                edges.push_back(make_tuple(e.weight, u, e.dest));
+    edges.reserve(getRouteCount());
+    for (int u : order) {
+        string_view name = nameOf(u);
+        for (const auto& arc : neighbors(u)) {
+            if (name < nameOf(arc.to)) {
+                edges.push_back(make_tuple(arc.weight, string(name), string(nameOf(arc.to))));
             }
         }
     }
     return edges;
 }
+
+int Graph::idCount() const {
+    return snapshot ? snapshot->idCount() : (int)names.size();
+}
+
+int Graph::findCity(string_view name) const {
+    return lookup(name);
+}
+
+string_view Graph::nameOf(int id) const {
+    if (snapshot) return snapshot->nameOf(id);
+    return names[id];
+}
+
+ArcRange Graph::neighbors(int id) const {
+    if (snapshot) return snapshot->arcsOf(id);
+    if (packed) return packed->arcsOf(id);
+    const auto& arcs = adj[id];
+    return {arcs.data(), arcs.data() + arcs.size()};
+}
+
+size_t Graph::degree(int id) const {
+    if (snapshot) return snapshot->arcsOf(id).size();
+    if (packed) return packed->degree(id);
+    return adj[id].size();
+}
+
+size_t Graph::getRouteCount() const {
+    return snapshot ? snapshot->getRouteCount() : routeCount;
+}
+
+int Graph::internCity(const string& name) {
+    thaw();
+    return intern(name);
+}
+
+size_t Graph::mergeRoutes(vector<RouteRecord>& records) {
+    thaw();
+    for (auto& r : records) {
+        if (r.a > r.b) swap(r.a, r.b);
+    }
+    // Stable, so the last record of each pair stays last in its run
+    stable_sort(records.begin(), records.end(), [](const RouteRecord& x, const RouteRecord& y) {
+        return x.a != y.a ? x.a < y.a : x.b < y.b;
+    });
+
+    size_t unique = 0;
+    for (size_t i = 0; i < records.size(); ++i) {
+        if (i + 1 < records.size() && records[i + 1].a == records[i].a && records[i + 1].b == records[i].b) {
+            continue;
+        }
+        records[unique++] = records[i];
+    }
+    size_t duplicates = records.size() - unique;
+    records.resize(unique);
+
+    // A small batch against a big graph is cheaper edge by edge
+    if (records.size() * 8 < routeCount) {
+        for (const auto& r : records) {
+            link(r.a, r.b, r.weight);
+        }
+        return duplicates;
+    }
+
+    // Otherwise fold the existing routes in as older records and rebuild
+    // every adjacency list in one counting pass
+    vector<RouteRecord> merged;
+    merged.reserve(routeCount + records.size());
+    for (int u = 0; u < (int)adj.size(); ++u) {
+        bool loopSeen = false;
+        for (const auto& arc : adj[u]) {
+            if (u < arc.to) merged.push_back({u, arc.to, arc.weight});
+            else if (u == arc.to && !loopSeen) {
+                merged.push_back({u, u, arc.weight});
+                loopSeen = true; // a self-loop is stored as two arcs
+            }
+        }
+    }
+    sort(merged.begin(), merged.end(), [](const RouteRecord& x, const RouteRecord& y) {
+        return x.a != y.a ? x.a < y.a : x.b < y.b;
+    });
+
+    vector<RouteRecord> result;
+    result.reserve(merged.size() + records.size());
+    size_t i = 0, j = 0;
+    while (i < merged.size() || j < records.size()) {
+        if (j == records.size()) { result.push_back(merged[i++]); continue; }
+        if (i == merged.size()) { result.push_back(records[j++]); continue; }
+        const RouteRecord& old = merged[i];
+        const RouteRecord& fresh = records[j];
+        if (old.a == fresh.a && old.b == fresh.b) {
+            result.push_back(fresh);
+            ++i; ++j;
+        } else if (old.a < fresh.a || (old.a == fresh.a && old.b < fresh.b)) {
+            result.push_back(merged[i++]);
+        } else {
+            result.push_back(records[j++]);
+        }
+    }
+
+    vector<int> degree(names.size(), 0);
+    for (const auto& r : result) {
+        degree[r.a]++;
+        degree[r.b]++;
+    }
+    cityCount = 0;
+    for (size_t u = 0; u < adj.size(); ++u) {
+        adj[u].clear();
+        adj[u].reserve(degree[u]);
+        if (degree[u] > 0) cityCount++;
+    }
+    for (const auto& r : result) {
+        adj[r.a].push_back({r.b, r.weight});
+        adj[r.b].push_back({r.a, r.weight});
+    }
+    routeCount = result.size();
+    return duplicates;
+}
+
+void Graph::renumber(const vector<int>& order) {
+    thaw();
+    int n = (int)names.size();
+    vector<int> newId(n);
+    for (int i = 0; i < n; ++i) newId[order[i]] = i;
+
+    vector<string> renamed(n);
+    vector<vector<Arc>> moved(n);
+    for (int i = 0; i < n; ++i) {
+        renamed[i] = move(names[order[i]]);
+        const auto& arcs = adj[order[i]];
+        moved[i].reserve(arcs.size());
+        for (const Arc& arc : arcs) moved[i].push_back({newId[arc.to], arc.weight});
+    }
+    names = move(renamed);
+    adj = move(moved);
+
+    ids.clear();
+    ids.reserve(n, names);
+    for (int id = 0; id < n; ++id) ids.insert(id, NameFold::hash(names[id]), names);
+}
+
+pair<size_t, size_t> Graph::compress() {
+    thaw();
+    size_t before = CompressedAdjacency::listBytes(adj);
+    packed = make_shared<const CompressedAdjacency>(adj);
+    vector<vector<Arc>>().swap(adj);
+    return {before, packed->memoryBytes()};
+}
+
+size_t Graph::nameBytesSize() const {
+    size_t total = 0;
+    for (int id = 0; id < idCount(); ++id) total += nameOf(id).size();
+    return total;
+}
+
+void Graph::exportNames(char* bytes, int64_t* offsets) const {
+    int64_t pos = 0;
+    offsets[0] = 0;
+    for (int id = 0; id < idCount(); ++id) {
+        string_view name = nameOf(id);
+        copy(name.begin(), name.end(), bytes + pos);
+        pos += name.size();
+        offsets[id + 1] = pos;
+    }
+}
+
+void Graph::exportRoutes(int32_t* source, int32_t* target, int32_t* weight) const {
+    size_t k = 0;
+    for (int u = 0; u < idCount(); ++u) {
+        bool loopSeen = false;
+        for (const auto& arc : neighbors(u)) {
+            if (arc.to < u || (arc.to == u && loopSeen)) continue;
+            if (arc.to == u) loopSeen = true; // a self-loop is stored as two arcs
+            source[k] = u;
+            target[k] = arc.to;
+            weight[k] = arc.weight;
+            ++k;
+        }
+    }
+}
+
+bool Graph::saveSnapshot(const string& path, string& error, int64_t journalSequence) {
+    int n = idCount();
+
+    vector<uint64_t> nameOffsets(n + 1, 0);
+    vector<uint64_t> arcOffsets(n + 1, 0);
+    string nameBytes;
+    vector<string_view> storedNames(n);
+    vector<Arc> arcs;
+    arcs.reserve(getRouteCount() * 2);
+
+    for (int id = 0; id < n; ++id) {
+        string_view name = nameOf(id);
+        nameBytes.append(name.data(), name.size());
+        nameOffsets[id + 1] = nameBytes.size();
+        storedNames[id] = name;
+
+        for (const Arc& arc : neighbors(id)) arcs.push_back(arc);
+        arcOffsets[id + 1] = arcs.size();
+    }
+    vector<int32_t> index = GraphSnapshot::buildNameIndex(storedNames);
+
+    vector<SnapshotSection> sections = {
+        {SECTION_NAME_OFFSETS, nameOffsets.data(), nameOffsets.size() * sizeof(uint64_t)},
+        {SECTION_NAME_BYTES, nameBytes.data(), nameBytes.size()},
+        {SECTION_NAME_INDEX, index.data(), index.size() * sizeof(int32_t)},
+        {SECTION_ARC_OFFSETS, arcOffsets.data(), arcOffsets.size() * sizeof(uint64_t)},
+        {SECTION_ARCS, arcs.data(), arcs.size() * sizeof(Arc)},
+        {SECTION_JOURNAL, &journalSequence, sizeof(journalSequence)},
+    };
+    return GraphSnapshot::write(path, sections, getCityCount(), getRouteCount(), error);
+}
+
+bool Graph::loadSnapshot(const string& path, string& error, bool verify, int64_t* journalSequence) {
+    shared_ptr<const GraphSnapshot> loaded = GraphSnapshot::open(path, error, verify);
+    if (!loaded) return false;
+    if (journalSequence) *journalSequence = loaded->getJournalSequence();
+
+    clear();
+    snapshot = loaded;
+    return true;
+}
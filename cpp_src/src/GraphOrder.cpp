@@ -0,0 +1,139 @@
+#include "../include/GraphOrder.h"
+#include <algorithm>
+#include <cstdlib>
+
+namespace {
+
+// BFS sweeps spent looking for a pseudo-peripheral start
+const int PERIPHERAL_TRIES = 4;
+
+// BFS over one component from source, appended to order; byDegree visits
+// each city's unseen neighbours fewest routes first
+struct Sweep {
+    size_t lastLevel; // index in order where the deepest level starts
+    int depth;        // levels below the source
+};
+
+Sweep component(const Graph& g, int source, bool byDegree, vector<char>& seen, vector<int>& order) {
+    Sweep sweep{order.size(), 0};
+    seen[source] = 1;
+    order.push_back(source);
+    size_t head = sweep.lastLevel, levelEnd = order.size();
+    vector<int> next;
+    while (head < order.size()) {
+        if (head == levelEnd) {
+            sweep.lastLevel = head;
+            sweep.depth++;
+            levelEnd = order.size();
+        }
+        int u = order[head++];
+        next.clear();
+        for (const Arc& arc : g.neighbors(u)) {
+            if (!seen[arc.to]) {
+                seen[arc.to] = 1;
+                next.push_back(arc.to);
+            }
+        }
+        if (byDegree) {
+            stable_sort(next.begin(), next.end(),
+                        [&](int a, int b) { return g.degree(a) < g.degree(b); });
+        }
+        order.insert(order.end(), next.begin(), next.end());
+    }
+    return sweep;
+}
+
+// Ids without routes, in id order, after the rest
+void appendIsolated(const Graph& g, vector<int>& order) {
+    for (int id = 0; id < g.idCount(); ++id) {
+        if (!g.isCity(id)) order.push_back(id);
+    }
+}
+
+} // namespace
+
+vector<int> GraphOrder::reverseCuthillMcKee(const Graph& g) {
+    int n = g.idCount();
+    vector<char> seen(n, 0);
+    vector<int> order;
+    order.reserve(n);
+    for (int start = 0; start < n; ++start) {
+        if (seen[start] || !g.isCity(start)) continue;
+
+        // Pseudo-peripheral start (George-Liu): move to a lowest-degree
+        // city of the deepest level while that makes the BFS deeper
+        size_t first = order.size();
+        auto probe = [&](int source, int& lowest) {
+            Sweep sweep = component(g, source, false, seen, order);
+            lowest = order[sweep.lastLevel];
+            for (size_t i = sweep.lastLevel; i < order.size(); ++i) {
+                if (g.degree(order[i]) < g.degree(lowest)) lowest = order[i];
+            }
+            for (size_t i = first; i < order.size(); ++i) seen[order[i]] = 0;
+            order.resize(first);
+            return sweep.depth;
+        };
+        int source = start, candidate;
+        int depth = probe(source, candidate);
+        for (int tries = 0; tries < PERIPHERAL_TRIES; ++tries) {
+            int next;
+            int candidateDepth = probe(candidate, next);
+            if (candidateDepth <= depth) break;
+            source = candidate;
+            depth = candidateDepth;
+            candidate = next;
+        }
+        component(g, source, true, seen, order);
+        reverse(order.begin() + first, order.end());
+    }
+    appendIsolated(g, order);
+    return order;
+}
+
+vector<int> GraphOrder::breadthFirst(const Graph& g) {
+    int n = g.idCount();
+    vector<char> seen(n, 0);
+    vector<int> order;
+    order.reserve(n);
+    for (int start = 0; start < n; ++start) {
+        if (!seen[start] && g.isCity(start)) component(g, start, false, seen, order);
+    }
+    appendIsolated(g, order);
+    return order;
+}
+
+vector<int> GraphOrder::byDegree(const Graph& g) {
+    vector<int> order;
+    order.reserve(g.idCount());
+    for (int id = 0; id < g.idCount(); ++id) {
+        if (g.isCity(id)) order.push_back(id);
+    }
+    stable_sort(order.begin(), order.end(),
+                [&](int a, int b) { return g.degree(a) > g.degree(b); });
+    appendIsolated(g, order);
+    return order;
+}
+
+bool GraphOrder::compute(const Graph& g, const string& method, vector<int>& order) {
+    if (method == "rcm") order = reverseCuthillMcKee(g);
+    else if (method == "bfs") order = breadthFirst(g);
+    else if (method == "degree") order = byDegree(g);
+    else return false;
+    return true;
+}
+
+vector<string> GraphOrder::methods() {
+    return {"rcm", "bfs", "degree"};
+}
+
+double GraphOrder::meanGap(const Graph& g) {
+    double total = 0;
+    size_t arcs = 0;
+    for (int id = 0; id < g.idCount(); ++id) {
+        for (const Arc& arc : g.neighbors(id)) {
+            total += abs(arc.to - id);
+            arcs++;
+        }
+    }
+    return arcs > 0 ? total / arcs : 0;
+}
@@ -0,0 +1,367 @@
+#include "../include/GraphSnapshot.h"
+#include "../include/NameFold.h"
+#include <cstdint>
+#include <cstring>
+#include <cstdio>
+#include <fstream>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+const char MAGIC[8] = {'P', 'F', 'G', 'R', 'A', 'P', 'H', '\0'};
+const uint32_t ENDIAN_TAG = 0x01020304;
+const uint32_t MAX_SECTIONS = 16;
+const uint64_t ALIGNMENT = 64;
+
+struct SectionEntry {
+    uint32_t kind;
+    uint32_t reserved;
+    uint64_t offset;
+    uint64_t bytes;
+};
+
+struct FileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t endianTag;
+    uint64_t fileSize;
+    uint64_t checksum;      // whole file, with this field read as zero
+    uint64_t cityCount;
+    uint64_t routeCount;
+    uint32_t sectionCount;
+    uint32_t reserved;
+    SectionEntry sections[MAX_SECTIONS];
+};
+
+uint64_t alignUp(uint64_t n) {
+    return (n + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+}
+
+// Word-at-a-time integrity hash; catches truncation and bit rot, not tampering.
+// Streaming: the digest does not depend on how the input is split into calls.
+class Checksum {
+    uint64_t h = 0x9E3779B97F4A7C15ULL;
+    uint64_t total = 0;
+    unsigned char pending[8];
+    size_t fill = 0;
+
+    static uint64_t rotl(uint64_t x, int r) { return (x << r) | (x >> (64 - r)); }
+    void mix(uint64_t w) {
+        h ^= w * 0x87C37B91114253D5ULL;
+        h = rotl(h, 31) * 0x4CF5AD432745937FULL;
+    }
+public:
+    void update(const void* data, size_t n) {
+        const unsigned char* p = static_cast<const unsigned char*>(data);
+        total += n;
+        while (n > 0) {
+            if (fill == 0 && n >= 8) {
+                size_t words = n / 8;
+                for (size_t i = 0; i < words; ++i) {
+                    uint64_t w;
+                    memcpy(&w, p + i * 8, 8);
+                    mix(w);
+                }
+                p += words * 8;
+                n -= words * 8;
+                continue;
+            }
+            pending[fill++] = *p++;
+            --n;
+            if (fill == 8) {
+                uint64_t w;
+                memcpy(&w, pending, 8);
+                mix(w);
+                fill = 0;
+            }
+        }
+    }
+    uint64_t digest() const {
+        Checksum c = *this;
+        if (c.fill > 0) {
+            uint64_t w = 0;
+            memcpy(&w, c.pending, c.fill);
+            c.mix(w);
+        }
+        c.mix(total);
+        uint64_t x = c.h;
+        x ^= x >> 33; x *= 0xFF51AFD7ED558CCDULL;
+        x ^= x >> 33; x *= 0xC4CEB9FE1A85EC53ULL;
+        x ^= x >> 33;
+        return x;
+    }
+};
+
+const SectionEntry* findSection(const FileHeader& h, uint32_t kind) {
+    for (uint32_t i = 0; i < h.sectionCount; ++i) {
+        if (h.sections[i].kind == kind) return &h.sections[i];
+    }
+    return nullptr;
+}
+
+} // namespace
+
+GraphSnapshot::~GraphSnapshot() {
+#ifndef _WIN32
+    if (mapped && base) munmap(const_cast<char*>(base), length);
+#endif
+}
+
+vector<int32_t> GraphSnapshot::buildNameIndex(const vector<string_view>& names) {
+    size_t slots = 8;
+    while (slots < names.size() * 2) slots <<= 1;
+
+    vector<int32_t> index(slots, -1);
+    for (size_t id = 0; id < names.size(); ++id) {
+        size_t i = NameFold::hash(names[id]) & (slots - 1);
+        while (index[i] != -1) i = (i + 1) & (slots - 1);
+        index[i] = (int32_t)id;
+    }
+    return index;
+}
+
+bool GraphSnapshot::write(const string& path, const vector<SnapshotSection>& sections,
+                          uint64_t cityCount, uint64_t routeCount, string& error) {
+    if (sections.size() > MAX_SECTIONS) {
+        error = "Too many snapshot sections.";
+        return false;
+    }
+
+    FileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.endianTag = ENDIAN_TAG;
+    header.cityCount = cityCount;
+    header.routeCount = routeCount;
+    header.sectionCount = (uint32_t)sections.size();
+
+    uint64_t offset = alignUp(sizeof(FileHeader));
+    for (size_t i = 0; i < sections.size(); ++i) {
+        header.sections[i].kind = sections[i].kind;
+        header.sections[i].offset = offset;
+        header.sections[i].bytes = sections[i].bytes;
+        offset = alignUp(offset + sections[i].bytes);
+    }
+    header.fileSize = offset;
+
+    static const char zeros[ALIGNMENT] = {};
+    Checksum sum;
+    sum.update(&header, sizeof(header));
+    sum.update(zeros, alignUp(sizeof(FileHeader)) - sizeof(FileHeader));
+    for (const auto& s : sections) {
+        sum.update(s.data, s.bytes);
+        sum.update(zeros, alignUp(s.bytes) - s.bytes);
+    }
+    header.checksum = sum.digest();
+
+    // Write to a sibling file and rename, so readers never map a partial snapshot
+    string tmp = path + ".tmp";
+    {
+        ofstream out(tmp, ios::binary | ios::trunc);
+        if (!out) {
+            error = "Cannot open '" + tmp + "' for writing.";
+            return false;
+        }
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(zeros, alignUp(sizeof(FileHeader)) - sizeof(FileHeader));
+        for (const auto& s : sections) {
+            out.write(static_cast<const char*>(s.data), s.bytes);
+            out.write(zeros, alignUp(s.bytes) - s.bytes);
+        }
+        if (!out) {
+            error = "Failed writing '" + tmp + "'.";
+            return false;
+        }
+    }
+    if (rename(tmp.c_str(), path.c_str()) != 0) {
+        remove(tmp.c_str());
+        error = "Cannot replace '" + path + "'.";
+        return false;
+    }
+    return true;
+}
+
+shared_ptr<const GraphSnapshot> GraphSnapshot::open(const string& path, string& error, bool verify) {
+    shared_ptr<GraphSnapshot> snap(new GraphSnapshot());
+
+#ifndef _WIN32
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        error = "Cannot open snapshot '" + path + "'.";
+        return nullptr;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        ::close(fd);
+        error = "Snapshot '" + path + "' is empty.";
+        return nullptr;
+    }
+    snap->length = (size_t)st.st_size;
+    void* addr = mmap(nullptr, snap->length, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (addr == MAP_FAILED) {
+        error = "Cannot map snapshot '" + path + "'.";
+        return nullptr;
+    }
+    snap->base = static_cast<const char*>(addr);
+    snap->mapped = true;
+#else
+    ifstream in(path, ios::binary | ios::ate);
+    if (!in) {
+        error = "Cannot open snapshot '" + path + "'.";
+        return nullptr;
+    }
+    snap->fallback.resize((size_t)in.tellg());
+    in.seekg(0);
+    in.read(snap->fallback.data(), snap->fallback.size());
+    snap->base = snap->fallback.data();
+    snap->length = snap->fallback.size();
+#endif
+
+    if (!snap->bind(error)) return nullptr;
+    if (verify && !snap->verify(error)) return nullptr;
+    return snap;
+}
+
+bool GraphSnapshot::bind(string& error) {
+    if (length < sizeof(FileHeader)) {
+        error = "Snapshot is truncated.";
+        return false;
+    }
+
+    FileHeader header;
+    memcpy(&header, base, sizeof(header));
+    if (memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0) {
+        error = "Not a graph snapshot.";
+        return false;
+    }
+    if (header.endianTag != ENDIAN_TAG) {
+        error = "Snapshot was written on a machine with different byte order.";
+        return false;
+    }
+    if (header.version != VERSION) {
+        error = "Unsupported snapshot version " + to_string(header.version) + ".";
+        return false;
+    }
+    if (header.fileSize != length || header.sectionCount > MAX_SECTIONS) {
+        error = "Snapshot is truncated or corrupt.";
+        return false;
+    }
+    for (uint32_t i = 0; i < header.sectionCount; ++i) {
+        const SectionEntry& s = header.sections[i];
+        if (s.offset % ALIGNMENT != 0 || s.offset > length || s.bytes > length - s.offset) {
+            error = "Snapshot section table is corrupt.";
+            return false;
+        }
+    }
+
+    const SectionEntry* offs = findSection(header, SECTION_NAME_OFFSETS);
+    const SectionEntry* bytes = findSection(header, SECTION_NAME_BYTES);
+    const SectionEntry* index = findSection(header, SECTION_NAME_INDEX);
+    const SectionEntry* rows = findSection(header, SECTION_ARC_OFFSETS);
+    const SectionEntry* arcList = findSection(header, SECTION_ARCS);
+    const SectionEntry* journalEntry = findSection(header, SECTION_JOURNAL);
+    if (!offs || !bytes || !index || !rows || !arcList) {
+        error = "Snapshot is missing a required section.";
+        return false;
+    }
+    if (offs->bytes < 8 || offs->bytes % 8 != 0 || rows->bytes != offs->bytes ||
+        arcList->bytes % sizeof(Arc) != 0 || index->bytes % 4 != 0) {
+        error = "Snapshot section sizes are inconsistent.";
+        return false;
+    }
+
+    if (journalEntry && journalEntry->bytes != sizeof(int64_t)) {
+        error = "Snapshot section sizes are inconsistent.";
+        return false;
+    }
+
+    ids = offs->bytes / 8 - 1;
+    cities = header.cityCount;
+    routes = header.routeCount;
+    nameOffsets = reinterpret_cast<const uint64_t*>(base + offs->offset);
+    nameBytes = base + bytes->offset;
+    nameIndex = reinterpret_cast<const int32_t*>(base + index->offset);
+    nameSlots = index->bytes / 4;
+    arcOffsets = reinterpret_cast<const uint64_t*>(base + rows->offset);
+    arcs = reinterpret_cast<const Arc*>(base + arcList->offset);
+    if (journalEntry) memcpy(&journal, base + journalEntry->offset, sizeof(journal));
+
+    if (ids > (uint64_t)INT32_MAX || nameSlots <= ids || (nameSlots & (nameSlots - 1)) != 0 ||
+        nameOffsets[ids] != bytes->bytes || arcOffsets[ids] != arcList->bytes / sizeof(Arc)) {
+        error = "Snapshot section sizes are inconsistent.";
+        return false;
+    }
+    for (uint64_t i = 0; i < ids; ++i) {
+        if (nameOffsets[i] > nameOffsets[i + 1] || arcOffsets[i] > arcOffsets[i + 1]) {
+            error = "Snapshot offsets are not monotonic.";
+            return false;
+        }
+    }
+
+    // Searches index per-city arrays by arc.to, and lookup() probes until
+    // an empty slot, so these hold even when the checksum is not checked
+    uint64_t arcCount = arcOffsets[ids];
+    for (uint64_t i = 0; i < arcCount; ++i) {
+        if (arcs[i].to < 0 || (uint64_t)arcs[i].to >= ids) {
+            error = "Snapshot route targets are out of range.";
+            return false;
+        }
+    }
+    bool emptySlot = false;
+    for (uint64_t i = 0; i < nameSlots; ++i) {
+        int32_t id = nameIndex[i];
+        if (id == -1) emptySlot = true;
+        else if (id < 0 || (uint64_t)id >= ids) {
+            error = "Snapshot name index is corrupt.";
+            return false;
+        }
+    }
+    if (!emptySlot) {
+        error = "Snapshot name index is corrupt.";
+        return false;
+    }
+    return true;
+}
+
+bool GraphSnapshot::verify(string& error) const {
+    FileHeader header;
+    memcpy(&header, base, sizeof(header));
+    uint64_t stored = header.checksum;
+    header.checksum = 0;
+    Checksum sum;
+    sum.update(&header, sizeof(header));
+    sum.update(base + sizeof(header), length - sizeof(header));
+    if (sum.digest() != stored) {
+        error = "Snapshot checksum mismatch.";
+        return false;
+    }
+    return true;
+}
+
+string_view GraphSnapshot::nameOf(int id) const {
+    return string_view(nameBytes + nameOffsets[id], nameOffsets[id + 1] - nameOffsets[id]);
+}
+
+ArcRange GraphSnapshot::arcsOf(int id) const {
+    return {arcs + arcOffsets[id], arcs + arcOffsets[id + 1]};
+}
+
+int GraphSnapshot::lookup(string_view name) const {
+    uint64_t mask = nameSlots - 1;
+    uint64_t i = NameFold::hash(name) & mask;
+
+    while (nameIndex[i] != -1) {
+        int id = nameIndex[i];
+        if (NameFold::equal(nameOf(id), name)) return id;
+        i = (i + 1) & mask;
+    }
+    return -1;
+}
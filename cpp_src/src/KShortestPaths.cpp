@@ -0,0 +1,268 @@
+#include "../include/KShortestPaths.h"
+#include "../include/QueryWorkspace.h"
+#include <algorithm>
+#include <functional>
+#include <set>
+
+namespace {
+
+struct Route {
+    vector<int> nodes;
+    vector<int> reached;  // distance from the start to each city of nodes
+    int deviation;        // first index whose outgoing route may differ from the parent path
+};
+
+// The reverse tree: settled (visited) cities know their exact distance to
+// the destination and, in parentOf(), their next hop towards it. Every other
+// city is at least `radius` away.
+struct ReverseTree {
+    QueryWorkspace& ws;
+    int radius;
+
+    int lowerBound(int id) const { return ws.visited(id) ? ws.dist(id) : radius; }
+};
+
+// Whether the tree path from id to the destination avoids every blocked
+// (visited) city of the spur search; memoized in spur.bound() as 1 / 0
+bool treeClean(const ReverseTree& tree, QueryWorkspace& spur, int id) {
+    vector<int>& walk = spur.path;
+    walk.clear();
+    int verdict;
+    for (int x = id;; x = tree.ws.parentOf(x)) {
+        int known = spur.bound(x);
+        if (known != INT_MAX) {
+            verdict = known;
+            break;
+        }
+        walk.push_back(x);
+        if (!tree.ws.visited(x) || spur.visited(x)) {
+            verdict = 0;
+            break;
+        }
+        if (tree.ws.parentOf(x) == -1) {
+            verdict = 1; // the destination
+            break;
+        }
+    }
+    for (int x : walk) spur.setBound(x, verdict);
+    return verdict == 1;
+}
+
+// A* from source to target over the cities not blocked in spur, skipping
+// the routes from source to `removed` and anything not shorter than budget.
+// Ends early at the first city whose tree path is clean, since its lower
+// bound is then exact and reachable. Returns the last city reached by the
+// search itself, or -1.
+int spurSearch(const Graph& g, const ReverseTree& tree, QueryWorkspace& spur, int source,
+               const vector<int>& removed, int budget, StatsProbe& probe) {
+    auto isRemoved = [&](int id) { return find(removed.begin(), removed.end(), id) != removed.end(); };
+
+    if (tree.lowerBound(source) >= budget) return -1;
+    spur.reach(source, 0, -1);
+    spur.heap.push(tree.lowerBound(source), source);
+    probe.pushed();
+
+    while (!spur.heap.empty()) {
+        IdNode top = spur.heap.pop();
+        probe.popped();
+        int reached = spur.dist(top.id);
+        if (top.weight > reached + tree.lowerBound(top.id)) {
+            probe.stale();
+            continue;
+        }
+        probe.settled();
+
+        // source itself is blocked, so only its first tree hop is checked
+        bool clean = top.id == source
+            ? tree.ws.visited(source) && !isRemoved(tree.ws.parentOf(source)) &&
+                  treeClean(tree, spur, tree.ws.parentOf(source))
+            : treeClean(tree, spur, top.id);
+        if (clean) return top.id;
+
+        for (const Arc& arc : g.neighbors(top.id)) {
+            probe.relaxed();
+            if (spur.visited(arc.to) || (top.id == source && isRemoved(arc.to))) continue;
+            int newDist = reached + arc.weight;
+            if (newDist < spur.dist(arc.to) && newDist + tree.lowerBound(arc.to) < budget) {
+                spur.reach(arc.to, newDist, top.id);
+                spur.heap.push(newDist + tree.lowerBound(arc.to), arc.to);
+                probe.pushed();
+                probe.frontier(spur.heap.size());
+            }
+        }
+    }
+    return -1;
+}
+
+} // namespace
+
+PathListResult KShortestPaths::find(Graph& g, string start, string end, int k, SearchStats* stats) {
+    PathListResult res;
+    res.found = false;
+
+    StatsProbe probe(stats);
+    PhaseTimer phases(stats);
+    phases.mark("resolve");
+
+    if (k < 1) {
+        res.message = "Number of paths must be positive.";
+        return res;
+    }
+    if (!g.hasNode(start) || !g.hasNode(end)) {
+        res.message = "One or both cities not found in the network.";
+        return res;
+    }
+
+    int source = g.findCity(start);
+    int target = g.findCity(end);
+
+    phases.mark("workspace");
+    ReverseTree tree{QueryWorkspace::acquire(g.idCount(), 0), 0};
+
+    // Routes are two-way: the tree from the destination gives every
+    // city's distance to it. Stops once the start is settled.
+    phases.mark("tree");
+    QueryWorkspace& ws = tree.ws;
+    ws.reach(target, 0, -1);
+    ws.heap.push(0, target);
+    probe.pushed();
+    while (!ws.heap.empty()) {
+        IdNode top = ws.heap.pop();
+        probe.popped();
+        if (top.weight > ws.dist(top.id)) {
+            probe.stale();
+            continue;
+        }
+        ws.visit(top.id);
+        tree.radius = top.weight;
+        probe.settled();
+        if (top.id == source) break;
+
+        for (const Arc& arc : g.neighbors(top.id)) {
+            probe.relaxed();
+            if (top.weight + arc.weight < ws.dist(arc.to)) {
+                ws.reach(arc.to, top.weight + arc.weight, top.id);
+                ws.heap.push(top.weight + arc.weight, arc.to);
+                probe.pushed();
+                probe.frontier(ws.heap.size());
+            }
+        }
+    }
+    if (!ws.visited(source)) {
+        res.message = "No route exists between these cities.";
+        return res;
+    }
+
+    phases.mark("search");
+    vector<Route> accepted(1);
+    for (int x = source; x != -1; x = ws.parentOf(x)) {
+        accepted[0].nodes.push_back(x);
+        accepted[0].reached.push_back(ws.dist(source) - ws.dist(x));
+    }
+    accepted[0].deviation = 0;
+
+    set<vector<int>> seen{accepted[0].nodes};
+    vector<Route> candidates;
+    vector<pair<int, int>> queue; // min-heap of (distance, candidate)
+    vector<int> best;             // max-heap of the `needed` shortest queued distances
+    vector<int> sharing;          // accepted paths that share the current root
+    vector<int> removed;
+
+    while ((int)accepted.size() < k) {
+        const Route& last = accepted.back();
+        size_t first = last.deviation;
+
+        // Once `needed` candidates are queued, a spur path no shorter than
+        // all of them can never be returned, so spur searches stop there
+        size_t needed = k - accepted.size();
+        best.clear();
+        for (const auto& queued : queue) best.push_back(queued.first);
+        if (best.size() > needed) {
+            nth_element(best.begin(), best.begin() + (needed - 1), best.end());
+            best.resize(needed);
+        }
+        make_heap(best.begin(), best.end());
+
+        sharing.clear();
+        for (size_t p = 0; p < accepted.size(); ++p) {
+            const vector<int>& nodes = accepted[p].nodes;
+            if (nodes.size() > first && equal(last.nodes.begin(), last.nodes.begin() + first, nodes.begin())) {
+                sharing.push_back((int)p);
+            }
+        }
+
+        for (size_t i = first; i + 1 < last.nodes.size(); ++i) {
+            // Routes out of the spur city taken by accepted paths sharing this root
+            removed.clear();
+            size_t kept = 0;
+            for (int p : sharing) {
+                const vector<int>& nodes = accepted[p].nodes;
+                if (nodes[i] != last.nodes[i]) continue;
+                sharing[kept++] = p;
+                if (nodes.size() > i + 1) removed.push_back(nodes[i + 1]);
+            }
+            sharing.resize(kept);
+
+            int spurCity = last.nodes[i];
+            QueryWorkspace& spur = QueryWorkspace::acquire(g.idCount(), 1);
+            for (size_t j = 0; j <= i; ++j) spur.visit(last.nodes[j]);
+
+            int rootDist = last.reached[i];
+            int budget = best.size() == needed ? best.front() - rootDist : INT_MAX;
+            int joint = spurSearch(g, tree, spur, spurCity, removed, budget, probe);
+            if (joint == -1) continue;
+
+            // Root, then the spur search's own cities, then the tree path
+            Route route;
+            route.deviation = (int)i;
+            route.nodes.assign(last.nodes.begin(), last.nodes.begin() + i);
+            route.reached.assign(last.reached.begin(), last.reached.begin() + i);
+            size_t spurStart = route.nodes.size();
+            for (int x = joint; x != -1; x = spur.parentOf(x)) {
+                route.nodes.push_back(x);
+                route.reached.push_back(rootDist + spur.dist(x));
+            }
+            reverse(route.nodes.begin() + spurStart, route.nodes.end());
+            reverse(route.reached.begin() + spurStart, route.reached.end());
+            int jointDist = route.reached.back();
+            for (int x = ws.parentOf(joint); x != -1; x = ws.parentOf(x)) {
+                route.nodes.push_back(x);
+                route.reached.push_back(jointDist + ws.dist(joint) - ws.dist(x));
+            }
+
+            if (!seen.insert(route.nodes).second) continue;
+            int distance = route.reached.back();
+            queue.push_back({distance, (int)candidates.size()});
+            push_heap(queue.begin(), queue.end(), greater<pair<int, int>>());
+            candidates.push_back(move(route));
+
+            if (best.size() == needed) { // within budget, so shorter than the top
+                pop_heap(best.begin(), best.end());
+                best.pop_back();
+            }
+            best.push_back(distance);
+            push_heap(best.begin(), best.end());
+        }
+
+        if (queue.empty()) break; // fewer than k loopless paths exist
+        pop_heap(queue.begin(), queue.end(), greater<pair<int, int>>());
+        accepted.push_back(move(candidates[queue.back().second]));
+        queue.pop_back();
+    }
+
+    phases.mark("path");
+    for (size_t i = 0; i < accepted.size(); ++i) {
+        ShortestPathResult path;
+        path.found = true;
+        path.distance = accepted[i].reached.back();
+        for (int id : accepted[i].nodes) path.path.emplace_back(g.nameOf(id));
+        path.message = "Path " + to_string(i + 1) + " of " + to_string(accepted.size()) + ".";
+        res.paths.push_back(move(path));
+    }
+
+    res.found = true;
+    res.message = (int)accepted.size() == k
+        ? "Found " + to_string(k) + " shortest paths."
+        : "Only " + to_string(accepted.size()) + " loopless paths exist.";
+    return res;
+}
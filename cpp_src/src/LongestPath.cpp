@@ -1,45 +1,41 @@
 #include "../include/LongestPath.h"
-#include <map>
-#include <algorithm>
 
-void LongestPath::dfsLongest(Graph& g, string current, string end, 
-                             map<string, bool>& visited, vector<string>& currentPath,
-                             int currentDist, vector<string>& bestPath, int& maxDist) {
+void LongestPath::dfsLongest(Graph& g, int current, int end, QueryWorkspace& ws, StatsProbe& probe,
+                             int currentDist, vector<int>& bestPath, int& maxDist) {
+    probe.recursed();
+    probe.frontier(ws.path.size());
     if (current == end) {
         if (currentDist > maxDist) {
             maxDist = currentDist;
-            bestPath = currentPath;
+            bestPath = ws.path;
         }
         return;
     }
-    
-    for (const auto& edge : g.getNeighbors(current)) {
-        if (!visited[edge.dest]) {
-            visited[edge.dest] = true;
-            currentPath.push_back(edge.dest);
-            
-            dfsLongest(g, edge.dest, end, visited, currentPath, 
-                      currentDist + edge.weight, bestPath, maxDist);
-            
-            currentPath.pop_back();
-            visited[edge.dest] = false;
+
+    for (const Arc& arc : g.neighbors(current)) {
+        probe.relaxed();
+        if (!ws.visited(arc.to)) {
+            ws.visit(arc.to);
+            ws.path.push_back(arc.to);
+
+            dfsLongest(g, arc.to, end, ws, probe, currentDist + arc.weight, bestPath, maxDist);
+
+            ws.path.pop_back();
+            ws.unvisit(arc.to);
         }
     }
 }
 
-LongestPathResult LongestPath::find(Graph& g, string start, string end) {
+LongestPathResult LongestPath::find(Graph& g, string start, string end, SearchStats* stats) {
     LongestPathResult res;
     res.found = false;
     res.distance = 0;
 
-    auto nodes = g.getNodes();
-    bool startExists = false, endExists = false;
-    for(const auto& n : nodes) {
-        if(n == start) startExists = true;
-        if(n == end) endExists = true;
-    }
+    StatsProbe probe(stats);
+    PhaseTimer phases(stats);
+    phases.mark("resolve");
 
-    if(!startExists || !endExists) {
+    if (!g.hasNode(start) || !g.hasNode(end)) {
         res.message = "One or both cities not found.";
         return res;
     }
@@ -49,19 +45,25 @@ LongestPathResult LongestPath::find(Graph& g, string start, string end) {
         return res;
     }
 
-    map<string, bool> visited;
-    vector<string> currentPath;
-    vector<string> bestPath;
+    int source = g.findCity(start);
+    int target = g.findCity(end);
+
+    phases.mark("workspace");
+    // visited() marks the cities on the current path
+    QueryWorkspace& ws = QueryWorkspace::acquire(g.idCount());
+    vector<int> bestPath;
     int maxDist = -1;
 
-    visited[start] = true;
-    currentPath.push_back(start);
+    ws.visit(source);
+    ws.path.push_back(source);
 
-    dfsLongest(g, start, end, visited, currentPath, 0, bestPath, maxDist);
+    phases.mark("search");
+    dfsLongest(g, source, target, ws, probe, 0, bestPath, maxDist);
+    phases.mark("path");
 
     if (maxDist >= 0) {
         res.found = true;
-        res.path = bestPath;
+        for (int id : bestPath) res.path.emplace_back(g.nameOf(id));
         res.distance = maxDist;
         res.message = "Longest path found.";
     } else {
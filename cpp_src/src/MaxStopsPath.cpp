@@ -0,0 +1,192 @@
+#include "../include/MaxStopsPath.h"
+#include "../include/QueryWorkspace.h"
+#include <algorithm>
+#include <climits>
+
+namespace {
+
+// A search label: reached `city` using `stops` routes, coming from label `parent`
+struct StopsLabel {
+    int city;
+    int stops;
+    int parent;
+};
+
+struct FrontHit {
+    int distance;
+    int label;
+};
+
+vector<string> labelPath(const Graph& g, const vector<StopsLabel>& labels, int label) {
+    vector<string> path;
+    for (int l = label; l != -1; l = labels[l].parent) {
+        path.emplace_back(g.nameOf(labels[l].city));
+    }
+    reverse(path.begin(), path.end());
+    return path;
+}
+
+// Labels reaching target in order of distance, each with fewer stops than
+// the one before. Stops after the first when wholeFront is false.
+vector<FrontHit> searchLabels(Graph& g, int source, int target, int maxStops, bool wholeFront,
+                              vector<StopsLabel>& labels, StatsProbe& probe, PhaseTimer& phases) {
+    vector<FrontHit> hits;
+
+    phases.mark("workspace");
+    QueryWorkspace& ws = QueryWorkspace::acquire(g.idCount());
+
+    // Lower bounds towards the destination; routes are two-way, so both
+    // come from searches out of target. hops(): fewest stops, up to the
+    // limit. dist(): distance inside that ball of cities, the A* heuristic.
+    // A route within the limit never leaves the ball, so dist() stays a
+    // lower bound, and the search costs no more than the limit allows.
+    phases.mark("bound");
+    ws.frontier.push_back(target);
+    ws.setHops(target, 0);
+    for (size_t head = 0; head < ws.frontier.size(); ++head) {
+        int u = ws.frontier[head];
+        if (ws.hops(u) == maxStops) continue;
+        for (const Arc& arc : g.neighbors(u)) {
+            if (ws.hops(arc.to) == INT_MAX) {
+                ws.setHops(arc.to, ws.hops(u) + 1);
+                ws.frontier.push_back(arc.to);
+            }
+        }
+    }
+    if (ws.hops(source) == INT_MAX) return hits;
+
+    ws.reach(target, 0, -1);
+    ws.heap.push(0, target);
+    while (!ws.heap.empty()) {
+        IdNode top = ws.heap.pop();
+        if (top.weight > ws.dist(top.id)) continue;
+        for (const Arc& arc : g.neighbors(top.id)) {
+            if (ws.hops(arc.to) == INT_MAX) continue;
+            if (top.weight + arc.weight < ws.dist(arc.to)) {
+                ws.reach(arc.to, top.weight + arc.weight, top.id);
+                ws.heap.push(top.weight + arc.weight, arc.to);
+            }
+        }
+    }
+
+    // A* over labels, keyed by distance plus dist(); labels of one city
+    // still pop in distance order. bound(city) holds the fewest stops
+    // settled at city so far.
+    phases.mark("search");
+    labels.push_back({source, 0, -1});
+    ws.heap.push(ws.dist(source), 0);
+    probe.pushed();
+
+    while (!ws.heap.empty()) {
+        IdNode top = ws.heap.pop();
+        probe.popped();
+        StopsLabel label = labels[top.id];
+        int distance = top.weight - ws.dist(label.city);
+
+        if (label.stops >= ws.bound(label.city)) {
+            probe.stale(); // dominated: the city was reached as short with fewer stops
+            continue;
+        }
+        ws.setBound(label.city, label.stops);
+        probe.settled();
+
+        if (label.city == target) {
+            hits.push_back({distance, top.id});
+            if (!wholeFront || label.stops == ws.hops(source)) break; // no fewer stops possible
+            continue;
+        }
+        if (label.stops == maxStops) continue;
+
+        int next = label.stops + 1;
+        int targetStops = ws.bound(target);
+        for (const Arc& arc : g.neighbors(label.city)) {
+            probe.relaxed();
+            int u = arc.to;
+            if (ws.hops(u) == INT_MAX || next + ws.hops(u) > maxStops) continue;
+            if (next >= ws.bound(u) || next + ws.hops(u) >= targetStops) continue;
+            labels.push_back({u, next, top.id});
+            ws.heap.push(distance + arc.weight + ws.dist(u), (int)labels.size() - 1);
+            probe.pushed();
+        }
+        probe.frontier(ws.heap.size());
+    }
+    return hits;
+}
+
+} // namespace
+
+ShortestPathResult MaxStopsPath::find(Graph& g, string start, string end, int maxStops,
+                                      SearchStats* stats) {
+    ShortestPathResult res;
+    res.found = false;
+    res.distance = 0;
+
+    StatsProbe probe(stats);
+    PhaseTimer phases(stats);
+    phases.mark("resolve");
+
+    if (maxStops < 0) {
+        res.message = "Maximum stops must not be negative.";
+        return res;
+    }
+    if (!g.hasNode(start) || !g.hasNode(end)) {
+        res.message = "One or both cities not found in the network.";
+        return res;
+    }
+
+    vector<StopsLabel> labels;
+    vector<FrontHit> hits = searchLabels(g, g.findCity(start), g.findCity(end), maxStops, false,
+                                         labels, probe, phases);
+    if (hits.empty()) {
+        res.message = "No route exists within " + to_string(maxStops) + " stops.";
+        return res;
+    }
+
+    phases.mark("path");
+    res.found = true;
+    res.distance = hits[0].distance;
+    res.path = labelPath(g, labels, hits[0].label);
+    res.message = "Shortest path within " + to_string(maxStops) + " stops found.";
+    return res;
+}
+
+StopsFrontResult MaxStopsPath::front(Graph& g, string start, string end, int maxStops,
+                                     SearchStats* stats) {
+    StopsFrontResult res;
+    res.found = false;
+
+    StatsProbe probe(stats);
+    PhaseTimer phases(stats);
+    phases.mark("resolve");
+
+    if (maxStops < 0) {
+        res.message = "Maximum stops must not be negative.";
+        return res;
+    }
+    if (!g.hasNode(start) || !g.hasNode(end)) {
+        res.message = "One or both cities not found in the network.";
+        return res;
+    }
+
+    vector<StopsLabel> labels;
+    vector<FrontHit> hits = searchLabels(g, g.findCity(start), g.findCity(end), maxStops, true,
+                                         labels, probe, phases);
+    if (hits.empty()) {
+        res.message = "No route exists within " + to_string(maxStops) + " stops.";
+        return res;
+    }
+
+    // Hits come shortest first with ever fewer stops; on a distance tie
+    // the later hit dominates the earlier one
+    phases.mark("path");
+    for (const FrontHit& hit : hits) {
+        if (!res.front.empty() && res.front.back().distance == hit.distance) res.front.pop_back();
+        res.front.push_back({labels[hit.label].stops, hit.distance, labelPath(g, labels, hit.label)});
+    }
+    reverse(res.front.begin(), res.front.end());
+
+    res.found = true;
+    res.message = "Found " + to_string(res.front.size()) + " trade-offs within " +
+                  to_string(maxStops) + " stops.";
+    return res;
+}
@@ -0,0 +1,235 @@
+#include "../include/Metrics.h"
+#include <cstdio>
+#include <sstream>
+
+// One thread's counters. Only the owning thread adds to them; readers and
+// reset() touch them concurrently, hence atomics with relaxed ordering.
+struct Metrics::Shard {
+    struct Op {
+        atomic<uint64_t> outcomes[METRIC_OUTCOMES];
+        atomic<uint64_t> totalNanos;
+        atomic<uint64_t> maxNanos;
+        atomic<uint64_t> buckets[LatencyBuckets::COUNT];
+    };
+    Op ops[METRIC_OPS];
+
+    Shard() {
+        for (auto& op : ops) {
+            for (auto& c : op.outcomes) c.store(0, memory_order_relaxed);
+            op.totalNanos.store(0, memory_order_relaxed);
+            op.maxNanos.store(0, memory_order_relaxed);
+            for (auto& b : op.buckets) b.store(0, memory_order_relaxed);
+        }
+    }
+};
+
+// Owns the calling thread's shard and hands it back on thread exit
+struct ShardHandle {
+    Metrics* owner = nullptr;
+    shared_ptr<Metrics::Shard> shard;
+    ~ShardHandle() {
+        if (shard) owner->retire(shard);
+    }
+};
+
+namespace {
+
+// Reads a counter, zeroing it when resetting
+uint64_t drain(atomic<uint64_t>& src, bool reset) {
+    return reset ? src.exchange(0, memory_order_relaxed) : src.load(memory_order_relaxed);
+}
+
+void raiseMax(atomic<uint64_t>& max, uint64_t value) {
+    uint64_t seen = max.load(memory_order_relaxed);
+    while (value > seen && !max.compare_exchange_weak(seen, value, memory_order_relaxed)) {}
+}
+
+string seconds(double s) {
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%.9g", s);
+    return buf;
+}
+
+} // namespace
+
+int LatencyBuckets::bucketOf(uint64_t nanos) {
+    if (nanos < (1ull << MIN_EXP)) return 0;
+#if defined(__GNUC__) || defined(__clang__)
+    int exp = 63 - __builtin_clzll(nanos);
+#else
+    int exp = MIN_EXP;
+    while (exp < 63 && (nanos >> (exp + 1))) exp++;
+#endif
+    if (exp > MAX_EXP) return COUNT - 1;
+    int sub = (nanos >> (exp - SUB_BITS)) & ((1 << SUB_BITS) - 1);
+    return 1 + ((exp - MIN_EXP) << SUB_BITS) + sub;
+}
+
+uint64_t LatencyBuckets::upperBound(int bucket) {
+    if (bucket == 0) return 1ull << MIN_EXP;
+    if (bucket >= COUNT - 1) return UINT64_MAX;
+    int exp = MIN_EXP + ((bucket - 1) >> SUB_BITS);
+    int sub = (bucket - 1) & ((1 << SUB_BITS) - 1);
+    return (1ull << exp) + ((uint64_t)(sub + 1) << (exp - SUB_BITS));
+}
+
+double OperationSnapshot::quantileSeconds(double q) const {
+    if (calls == 0) return 0;
+    uint64_t rank = (uint64_t)(q * calls);
+    if (rank >= calls) rank = calls - 1;
+    uint64_t seen = 0;
+    for (size_t i = 0; i < buckets.size(); ++i) {
+        seen += buckets[i];
+        if (seen > rank) {
+            uint64_t bound = LatencyBuckets::upperBound(i);
+            return (bound < maxNanos ? bound : maxNanos) / 1e9;
+        }
+    }
+    return maxNanos / 1e9;
+}
+
+Metrics::Metrics() : retired(make_shared<Shard>()) {}
+
+// Never destroyed: pool threads may still record during static destruction
+Metrics& Metrics::global() {
+    static Metrics* instance = new Metrics();
+    return *instance;
+}
+
+Metrics::Shard& Metrics::local() {
+    thread_local ShardHandle handle;
+    if (!handle.shard) {
+        handle.owner = this;
+        handle.shard = make_shared<Shard>();
+        lock_guard<mutex> lock(shardsMutex);
+        shards.push_back(handle.shard);
+    }
+    return *handle.shard;
+}
+
+void Metrics::retire(const shared_ptr<Shard>& shard) {
+    lock_guard<mutex> lock(shardsMutex);
+    for (int o = 0; o < METRIC_OPS; ++o) {
+        auto& from = shard->ops[o];
+        auto& to = retired->ops[o];
+        for (int k = 0; k < METRIC_OUTCOMES; ++k) {
+            to.outcomes[k].fetch_add(from.outcomes[k].load(memory_order_relaxed), memory_order_relaxed);
+        }
+        to.totalNanos.fetch_add(from.totalNanos.load(memory_order_relaxed), memory_order_relaxed);
+        raiseMax(to.maxNanos, from.maxNanos.load(memory_order_relaxed));
+        for (int b = 0; b < LatencyBuckets::COUNT; ++b) {
+            to.buckets[b].fetch_add(from.buckets[b].load(memory_order_relaxed), memory_order_relaxed);
+        }
+    }
+    for (size_t i = 0; i < shards.size(); ++i) {
+        if (shards[i] == shard) {
+            shards[i] = shards.back();
+            shards.pop_back();
+            break;
+        }
+    }
+}
+
+void Metrics::record(MetricOp op, MetricOutcome outcome, uint64_t nanos) {
+    Shard::Op& s = local().ops[(int)op];
+    s.outcomes[(int)outcome].fetch_add(1, memory_order_relaxed);
+    s.totalNanos.fetch_add(nanos, memory_order_relaxed);
+    raiseMax(s.maxNanos, nanos);
+    s.buckets[LatencyBuckets::bucketOf(nanos)].fetch_add(1, memory_order_relaxed);
+}
+
+vector<OperationSnapshot> Metrics::snapshot(bool reset) {
+    vector<OperationSnapshot> result(METRIC_OPS);
+    for (int o = 0; o < METRIC_OPS; ++o) {
+        result[o].operation = opName((MetricOp)o);
+        result[o].buckets.assign(LatencyBuckets::COUNT, 0);
+    }
+
+    lock_guard<mutex> lock(shardsMutex);
+    vector<Shard*> all = {retired.get()};
+    for (const auto& shard : shards) all.push_back(shard.get());
+
+    for (Shard* shard : all) {
+        for (int o = 0; o < METRIC_OPS; ++o) {
+            auto& from = shard->ops[o];
+            OperationSnapshot& to = result[o];
+            for (int k = 0; k < METRIC_OUTCOMES; ++k) {
+                uint64_t n = drain(from.outcomes[k], reset);
+                to.outcomes[k] += n;
+                to.calls += n;
+            }
+            to.totalNanos += drain(from.totalNanos, reset);
+            to.maxNanos = max(to.maxNanos, drain(from.maxNanos, reset));
+            for (int b = 0; b < LatencyBuckets::COUNT; ++b) {
+                to.buckets[b] += drain(from.buckets[b], reset);
+            }
+        }
+    }
+    return result;
+}
+
+string Metrics::prometheusText() {
+    vector<OperationSnapshot> ops = snapshot();
+    ostringstream out;
+
+    out << "# HELP pathfinder_calls_total PathFinder calls by operation.\n";
+    out << "# TYPE pathfinder_calls_total counter\n";
+    for (const auto& op : ops) {
+        out << "pathfinder_calls_total{operation=\"" << op.operation << "\"} " << op.calls << "\n";
+    }
+
+    out << "# HELP pathfinder_errors_total Failed PathFinder calls by operation and reason.\n";
+    out << "# TYPE pathfinder_errors_total counter\n";
+    for (const auto& op : ops) {
+        for (int k = 1; k < METRIC_OUTCOMES; ++k) {
+            out << "pathfinder_errors_total{operation=\"" << op.operation << "\",reason=\""
+                << outcomeName((MetricOutcome)k) << "\"} " << op.outcomes[k] << "\n";
+        }
+    }
+
+    // Exported at power-of-two bounds from ~1us to ~34s, where the fine
+    // buckets line up exactly; operations never called are left out
+    out << "# HELP pathfinder_latency_seconds PathFinder call latency, lock waits included.\n";
+    out << "# TYPE pathfinder_latency_seconds histogram\n";
+    for (const auto& op : ops) {
+        if (op.calls == 0) continue;
+        string labels = "operation=\"" + op.operation + "\"";
+        uint64_t cumulative = op.buckets[0];
+        int bucket = 1;
+        for (int exp = 10; exp <= 35; ++exp) {
+            while (bucket < LatencyBuckets::COUNT - 1 && LatencyBuckets::upperBound(bucket) <= (1ull << exp)) {
+                cumulative += op.buckets[bucket++];
+            }
+            out << "pathfinder_latency_seconds_bucket{" << labels << ",le=\"" << seconds((1ull << exp) / 1e9)
+                << "\"} " << cumulative << "\n";
+        }
+        out << "pathfinder_latency_seconds_bucket{" << labels << ",le=\"+Inf\"} " << op.calls << "\n";
+        out << "pathfinder_latency_seconds_sum{" << labels << "} " << seconds(op.totalNanos / 1e9) << "\n";
+        out << "pathfinder_latency_seconds_count{" << labels << "} " << op.calls << "\n";
+    }
+    return out.str();
+}
+
+const char* Metrics::opName(MetricOp op) {
+    static const char* names[METRIC_OPS] = {
+        "add_city", "update_city", "remove_city", "add_routes", "load_routes_file", "add_routes_arrays",
+        "find_shortest_path", "find_longest_path", "find_fewest_stops", "find_reachable_cities",
+        "plan_multi_city_tour", "find_cheapest_network", "get_all_cities", "get_all_routes", "clear_all",
+        "export_names", "export_routes", "city_ids", "save", "load",
+        "find_shortest_path_with_max_stops", "find_stops_pareto_front", "find_k_shortest_paths",
+        "find_alternative_routes", "cities_within", "cities_within_stops", "isochrone_bands",
+        "nearest_cities", "build_hierarchy", "update_routes", "distance_matrix", "distances_from",
+        "distance_table", "connected_components", "reorder", "compress", "apply_changes",
+    };
+    return names[(int)op];
+}
+
+const char* Metrics::outcomeName(MetricOutcome outcome) {
+    static const char* names[METRIC_OUTCOMES] = {"ok", "unknown_city", "no_route", "invalid_input", "io_error"};
+    return names[(int)outcome];
+}
+
+MetricTimer::~MetricTimer() {
+    auto nanos = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - started).count();
+    Metrics::global().record(op, outcome, (uint64_t)nanos);
+}
@@ -4,7 +4,9 @@
 
 void MultiCityTour::tspHelper(Graph& g, vector<string>& cities, vector<bool>& visited, 
                               string current, int count, int cost, int& minCost, 
-                              vector<string>& currentPath, vector<string>& bestPath) {
+                              vector<string>& currentPath, vector<string>& bestPath, StatsProbe& probe) {
+    probe.recursed();
+    probe.frontier(count);
     if (count == (int)cities.size()) {
         if (cost < minCost) {
             minCost = cost;
@@ -18,6 +20,7 @@ void MultiCityTour::tspHelper(Graph& g, vector<string>& cities, vector<bool>& vi
             int distToNext = -1;
             vector<Edge> neighbors = g.getNeighbors(current);
             for (const auto& edge : neighbors) {
+                probe.relaxed();
                 if (edge.dest == cities[i]) {
                     distToNext = edge.weight;
                     break;
@@ -29,7 +32,7 @@ void MultiCityTour::tspHelper(Graph& g, vector<string>& cities, vector<bool>& vi
                 currentPath.push_back(cities[i]);
                 
                 tspHelper(g, cities, visited, cities[i], count + 1, 
-                          cost + distToNext, minCost, currentPath, bestPath);
+                          cost + distToNext, minCost, currentPath, bestPath, probe);
                 
                 currentPath.pop_back();
                 visited[i] = false;
@@ -38,11 +41,15 @@ void MultiCityTour::tspHelper(Graph& g, vector<string>& cities, vector<bool>& vi
     }
 }
 
-TourResult MultiCityTour::plan(Graph& g, vector<string> cities) {
+TourResult MultiCityTour::plan(Graph& g, vector<string> cities, SearchStats* stats) {
     TourResult res;
     res.found = false;
     res.totalDistance = 0;
 
+    StatsProbe probe(stats);
+    PhaseTimer phases(stats);
+    phases.mark("resolve");
+
     if (cities.empty()) {
         res.message = "No cities provided.";
         return res;
@@ -73,7 +80,8 @@ TourResult MultiCityTour::plan(Graph& g, vector<string> cities) {
     visited[0] = true;
     currentPath.push_back(cities[0]);
 
-    tspHelper(g, cities, visited, cities[0], 1, 0, minCost, currentPath, bestPath);
+    phases.mark("search");
+    tspHelper(g, cities, visited, cities[0], 1, 0, minCost, currentPath, bestPath, probe);
 
     if (minCost != INT_MAX) {
         res.found = true;
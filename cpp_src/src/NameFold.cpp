@@ -0,0 +1,267 @@
+#include "../include/NameFold.h"
+#include <cstring>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+const uint64_t HIGH_BITS = 0x8080808080808080ULL;
+
+// Simple lowercase of a two-byte UTF-8 code point (U+0080..U+07FF); the
+// result always stays in that range
+uint32_t foldCodePoint(uint32_t cp) {
+    if (cp >= 0xC0 && cp <= 0xDE && cp != 0xD7) return cp + 0x20;   // Latin-1
+    if (cp >= 0x100 && cp <= 0x17E) {                                 // Latin Extended-A
+        if (cp == 0x130 || cp == 0x131 || cp == 0x138 || cp == 0x149) return cp; // no same-length pair
+        if (cp == 0x178) return 0xFF;
+        bool evenUpper = cp < 0x138 || (cp >= 0x14A && cp < 0x178);
+        return (cp % 2 == 0) == evenUpper ? cp + 1 : cp;
+    }
+    if (cp >= 0x391 && cp <= 0x3AB && cp != 0x3A2) return cp + 0x20; // Greek
+    if (cp >= 0x400 && cp <= 0x40F) return cp + 0x50;                // Cyrillic Ѐ..Џ
+    if (cp >= 0x410 && cp <= 0x42F) return cp + 0x20;                // Cyrillic А..Я
+    return cp;
+}
+
+// Lowercases 8 ASCII bytes at once; w must have no high bit set
+uint64_t foldAsciiWord(uint64_t w) {
+    uint64_t atLeastA = w + 0x3F3F3F3F3F3F3F3FULL; // high bit set where byte >= 'A'
+    uint64_t aboveZ = w + 0x2525252525252525ULL;   // high bit set where byte > 'Z'
+    return w | ((atLeastA & ~aboveZ & HIGH_BITS) >> 2);
+}
+
+// Index of the lowest byte whose high bit is set in mask
+int lowestByte(uint64_t mask) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(mask) >> 3;
+#else
+    int i = 0;
+    while (!(mask & 0x80)) {
+        mask >>= 8;
+        i++;
+    }
+    return i;
+#endif
+}
+
+// Folds the 8 bytes of w in place, high marking its bytes >= 0x80.
+// Returns how many leading bytes are final: 7 if the last byte starts a
+// two-byte sequence, else 8.
+size_t foldMixedWord(uint64_t& w, uint64_t high) {
+    uint64_t low = w & ~HIGH_BITS;
+    uint64_t upper = (low + 0x3F3F3F3F3F3F3F3FULL) & ~(low + 0x2525252525252525ULL) & HIGH_BITS & ~high;
+    w |= upper >> 2;
+
+    // Lead bytes 110xxxxx: bit 7 and bit 6 set, bit 5 clear
+    uint64_t leads = w & (w << 1) & ~(w << 2) & high;
+    while (leads) {
+        int i = lowestByte(leads);
+        leads &= leads - 1;
+        if (i == 7) return 7;
+        uint32_t next = (w >> (8 * i + 8)) & 0xFF;
+        if ((next & 0xC0) != 0x80) continue;
+        uint32_t c = (w >> (8 * i)) & 0xFF;
+        uint32_t cp = foldCodePoint(((c & 0x1Fu) << 6) | (next & 0x3Fu));
+        uint64_t pair = (uint64_t)(0xC0 | (cp >> 6)) | (uint64_t)(0x80 | (cp & 0x3F)) << 8;
+        w = (w & ~(0xFFFFULL << (8 * i))) | pair << (8 * i);
+    }
+    return 8;
+}
+
+// Word-at-a-time hash of a byte stream fed in arbitrary pieces
+class Hasher {
+    uint64_t h = 0x9E3779B97F4A7C15ULL;
+    uint64_t partial = 0;
+    int fill = 0;
+    uint64_t length = 0;
+
+    void mix(uint64_t w) {
+        h = (h ^ w) * 0xBF58476D1CE4E5B9ULL;
+        h ^= h >> 31;
+    }
+
+public:
+    void add(const char* p, size_t n) {
+        length += n;
+        while (n > 0 && fill > 0) {
+            partial |= (uint64_t)(unsigned char)*p++ << (8 * fill++);
+            n--;
+            if (fill == 8) {
+                mix(partial);
+                partial = 0;
+                fill = 0;
+            }
+        }
+        for (; n >= 8; p += 8, n -= 8) {
+            uint64_t w;
+            memcpy(&w, p, 8);
+            mix(w);
+        }
+        for (; n > 0; n--) partial |= (uint64_t)(unsigned char)*p++ << (8 * fill++);
+    }
+
+    uint64_t finish() {
+        mix(partial ^ (length << 56));
+        h ^= h >> 33;
+        h *= 0xFF51AFD7ED558CCDULL;
+        h ^= h >> 33;
+        return h;
+    }
+};
+
+} // namespace
+
+size_t NameFold::foldChunk(string_view name, size_t& pos, char* out, size_t room) {
+    const char* s = name.data();
+    size_t n = name.size();
+    size_t written = 0;
+
+    while (pos < n && written < room) {
+#if defined(__SSE2__)
+        if (n - pos >= 16 && room - written >= 16) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + pos));
+            if (_mm_movemask_epi8(v) == 0) {
+                __m128i upper = _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8('A' - 1)),
+                                              _mm_cmplt_epi8(v, _mm_set1_epi8('Z' + 1)));
+                v = _mm_or_si128(v, _mm_and_si128(upper, _mm_set1_epi8(0x20)));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + written), v);
+                pos += 16;
+                written += 16;
+                continue;
+            }
+        }
+#endif
+        if (n - pos >= 8 && room - written >= 8) {
+            uint64_t w;
+            memcpy(&w, s + pos, 8);
+            uint64_t high = w & HIGH_BITS;
+            if (high == 0) {
+                w = foldAsciiWord(w);
+                memcpy(out + written, &w, 8);
+                pos += 8;
+                written += 8;
+                continue;
+            }
+            // Mixed word: fold its ASCII bytes at once, then the two-byte
+            // sequences; one whose second byte lies beyond the word waits
+            size_t take = foldMixedWord(w, high);
+            memcpy(out + written, &w, 8);
+            pos += take;
+            written += take;
+            continue;
+        }
+
+        unsigned char c = s[pos];
+        if (c < 0x80) {
+            out[written++] = (c >= 'A' && c <= 'Z') ? (char)(c | 0x20) : (char)c;
+            pos++;
+        } else if ((c & 0xE0) == 0xC0 && pos + 1 < n && ((unsigned char)s[pos + 1] & 0xC0) == 0x80) {
+            if (room - written < 2) break;
+            uint32_t cp = foldCodePoint(((c & 0x1Fu) << 6) | ((unsigned char)s[pos + 1] & 0x3Fu));
+            out[written++] = (char)(0xC0 | (cp >> 6));
+            out[written++] = (char)(0x80 | (cp & 0x3F));
+            pos += 2;
+        } else {
+            out[written++] = (char)c; // longer sequences have no folded letters here
+            pos++;
+        }
+    }
+    return written;
+}
+
+uint64_t NameFold::hash(string_view name) {
+    Hasher hasher;
+    char buf[64];
+    size_t pos = 0;
+    while (pos < name.size()) {
+        size_t k = foldChunk(name, pos, buf, sizeof(buf));
+        hasher.add(buf, k);
+    }
+    return hasher.finish();
+}
+
+// Folding keeps the high bit of every byte and where each sequence starts,
+// so two names are walked word by word in lockstep
+bool NameFold::equal(string_view a, string_view b) {
+    if (a.size() != b.size()) return false;
+
+    size_t n = a.size(), k = 0;
+    while (n - k >= 8) {
+        uint64_t x, y;
+        memcpy(&x, a.data() + k, 8);
+        memcpy(&y, b.data() + k, 8);
+        size_t take = ((x >> 56) & 0xE0) == 0xC0 ? 7 : 8; // keep a split sequence whole
+        if (x != y) {
+            uint64_t high = x & HIGH_BITS;
+            if (high != (y & HIGH_BITS)) return false;
+            if (high == 0) {
+                if (foldAsciiWord(x) != foldAsciiWord(y)) return false;
+            } else {
+                foldMixedWord(x, high);
+                foldMixedWord(y, high);
+                uint64_t kept = take == 8 ? ~0ULL : 0x00FFFFFFFFFFFFFFULL;
+                if ((x ^ y) & kept) return false;
+            }
+        }
+        k += take;
+    }
+
+    char left[16], right[16];
+    size_t pa = k, pb = k;
+    size_t ka = foldChunk(a, pa, left, sizeof(left));
+    size_t kb = foldChunk(b, pb, right, sizeof(right));
+    return ka == kb && memcmp(left, right, ka) == 0;
+}
+
+string NameFold::fold(string_view name) {
+    string folded(name.size(), '\0');
+    size_t pos = 0, written = 0;
+    while (pos < name.size()) {
+        written += foldChunk(name, pos, &folded[written], folded.size() - written);
+    }
+    return folded;
+}
+
+int NameTable::find(string_view name, uint64_t hash, const vector<string>& names) const {
+    if (slots.empty()) return -1;
+    size_t mask = slots.size() - 1;
+    uint32_t tag = (uint32_t)(hash >> 32);
+    for (size_t i = hash & mask; slots[i].id != -1; i = (i + 1) & mask) {
+        if (slots[i].tag == tag && NameFold::equal(names[slots[i].id], name)) return slots[i].id;
+    }
+    return -1;
+}
+
+void NameTable::insert(int id, uint64_t hash, const vector<string>& names) {
+    if ((used + 1) * 2 > slots.size()) rehash(used + 1, names);
+    size_t mask = slots.size() - 1;
+    size_t i = hash & mask;
+    while (slots[i].id != -1) i = (i + 1) & mask;
+    slots[i] = {(int32_t)id, (uint32_t)(hash >> 32)};
+    used++;
+}
+
+void NameTable::reserve(size_t count, const vector<string>& names) {
+    if (count * 2 > slots.size()) rehash(count, names);
+}
+
+void NameTable::rehash(size_t count, const vector<string>& names) {
+    size_t size = 16;
+    while (size < count * 2) size <<= 1;
+
+    vector<Slot> old(size, Slot{-1, 0});
+    old.swap(slots);
+    size_t mask = size - 1;
+    for (const Slot& slot : old) {
+        if (slot.id == -1) continue;
+        size_t i = NameFold::hash(names[slot.id]) & mask;
+        while (slots[i].id != -1) i = (i + 1) & mask;
+        slots[i] = slot;
+    }
+}
+
+void NameTable::clear() {
+    slots.clear();
+    used = 0;
+}
@@ -0,0 +1,78 @@
+#include "../include/NearestCities.h"
+#include "../include/QueryWorkspace.h"
+
+CitiesWithinResult NearestCities::find(Graph& g, string start, int k, const vector<string>& candidates,
+                                       const function<bool(string_view)>& filter, SearchStats* stats) {
+    CitiesWithinResult res;
+    res.found = false;
+
+    StatsProbe probe(stats);
+    PhaseTimer phases(stats);
+    phases.mark("resolve");
+
+    if (k < 1) {
+        res.message = "Number of cities must be positive.";
+        return res;
+    }
+    if (!g.hasNode(start)) {
+        res.message = "City not found in the network.";
+        return res;
+    }
+
+    int source = g.findCity(start);
+
+    // bound() == 1 marks a candidate; unknown names are ignored
+    phases.mark("workspace");
+    QueryWorkspace& ws = QueryWorkspace::acquire(g.idCount());
+    int pending = 0;
+    for (const string& name : candidates) {
+        int id = g.findCity(name);
+        if (id < 0 || id == source || ws.bound(id) == 1 || !g.isCity(id)) continue;
+        ws.setBound(id, 1);
+        pending++;
+    }
+    bool anyCity = candidates.empty();
+
+    phases.mark("search");
+    ws.reach(source, 0, -1);
+    ws.setHops(source, 0);
+    ws.heap.push(0, source);
+    probe.pushed();
+
+    while (!ws.heap.empty()) {
+        IdNode top = ws.heap.pop();
+        probe.popped();
+        if (top.weight > ws.dist(top.id)) {
+            probe.stale();
+            continue;
+        }
+        probe.settled();
+
+        if (top.id != source && (anyCity || ws.bound(top.id) == 1)) {
+            if (!anyCity) pending--;
+            if (!filter || filter(g.nameOf(top.id))) {
+                res.cities.push_back({string(g.nameOf(top.id)), top.weight, ws.hops(top.id)});
+                if ((int)res.cities.size() == k) break;
+            }
+            if (!anyCity && pending == 0) break;
+        }
+
+        for (const Arc& arc : g.neighbors(top.id)) {
+            probe.relaxed();
+            int newDist = top.weight + arc.weight;
+            if (newDist < ws.dist(arc.to)) {
+                ws.reach(arc.to, newDist, top.id);
+                ws.setHops(arc.to, ws.hops(top.id) + 1);
+                ws.heap.push(newDist, arc.to);
+                probe.pushed();
+                probe.frontier(ws.heap.size());
+            }
+        }
+    }
+
+    res.found = true;
+    res.message = (int)res.cities.size() == k
+        ? "Found the " + to_string(k) + " nearest cities."
+        : "Only " + to_string(res.cities.size()) + " matching cities are reachable.";
+    return res;
+}
@@ -1,31 +1,51 @@
 #include "../include/PathFinder.h"
+#include <algorithm>
+#include <cmath>
+
+PathFinder& PathFinder::shared() {
+    static PathFinder* instance = new PathFinder();
+    return *instance;
+}
 
 OperationResult PathFinder::addCity(string city1, string city2, int distance) {
+    MetricTimer timer(MetricOp::AddCity);
     OperationResult res;
     if (distance <= 0) {
+        timer.fail(MetricOutcome::InvalidInput);
         res.success = false;
         res.message = "Distance must be positive.";
         return res;
     }
     
+    unique_lock<shared_mutex> lock(graphMutex);
+    int oldWeight = graph.getEdgeWeight(city1, city2);
     graph.addEdge(city1, city2, distance);
+    repairTrees(city1, city2, oldWeight, distance);
+    updateHierarchy(city1, city2, distance);
     res.success = true;
     res.message = "Route added: " + city1 + " <-> " + city2 + " (" + to_string(distance) + " km)";
     return res;
 }
 
 OperationResult PathFinder::updateCity(string city1, string city2, int distance) {
+    MetricTimer timer(MetricOp::UpdateCity);
     OperationResult res;
     if (distance <= 0) {
+        timer.fail(MetricOutcome::InvalidInput);
         res.success = false;
         res.message = "Distance must be positive.";
         return res;
     }
     
+    unique_lock<shared_mutex> lock(graphMutex);
+    int oldWeight = graph.getEdgeWeight(city1, city2);
     if (graph.updateEdge(city1, city2, distance)) {
+        repairTrees(city1, city2, oldWeight, distance);
+        updateHierarchy(city1, city2, distance);
         res.success = true;
         res.message = "Route updated: " + city1 + " <-> " + city2 + " (" + to_string(distance) + " km)";
     } else {
+        timer.fail(MetricOutcome::NoRoute);
         res.success = false;
         res.message = "Route not found. Use 'Add Route' to create it.";
     }
@@ -33,48 +53,416 @@ OperationResult PathFinder::updateCity(string city1, string city2, int distance)
 }
 
 OperationResult PathFinder::removeCity(string city1, string city2) {
+    MetricTimer timer(MetricOp::RemoveCity);
     OperationResult res;
+    unique_lock<shared_mutex> lock(graphMutex);
     if (!graph.hasEdge(city1, city2)) {
+        timer.fail(MetricOutcome::NoRoute);
         res.success = false;
         res.message = "Route not found.";
         return res;
     }
     
+    int oldWeight = graph.getEdgeWeight(city1, city2);
     graph.removeEdge(city1, city2);
+    repairTrees(city1, city2, oldWeight, -1);
+    updateHierarchy(city1, city2, -1);
     res.success = true;
     res.message = "Route removed: " + city1 + " <-> " + city2;
     return res;
 }
 
+BulkLoadResult PathFinder::addRoutes(const vector<tuple<string, string, int>>& routes) {
+    MetricTimer timer(MetricOp::AddRoutes);
+    unique_lock<shared_mutex> lock(graphMutex);
+    RouteLoader loader(graph);
+    for (const auto& route : routes) {
+        loader.add(get<0>(route), get<1>(route), get<2>(route));
+    }
+    // A batch can touch any part of every tree; rebuild them lazily instead
+    dropTrees();
+    hierarchy.reset();
+    return loader.commit();
+}
+
+BulkLoadResult PathFinder::loadRoutesFile(string path) {
+    MetricTimer timer(MetricOp::LoadRoutesFile);
+    unique_lock<shared_mutex> lock(graphMutex);
+    BulkLoadResult res = RouteLoader::loadFile(graph, path);
+    if (!res.success) timer.fail(MetricOutcome::IoError);
+    dropTrees();
+    hierarchy.reset();
+    return res;
+}
+
+BulkLoadResult PathFinder::addRoutesColumns(const vector<string>& names, const int32_t* source,
+                                            const int32_t* target, const int32_t* weight, size_t count) {
+    MetricTimer timer(MetricOp::AddRoutesArrays);
+    unique_lock<shared_mutex> lock(graphMutex);
+    RouteLoader loader(graph);
+    loader.addColumns(names, source, target, weight, count);
+    dropTrees();
+    hierarchy.reset();
+    return loader.commit();
+}
+
+OperationResult PathFinder::updateRoutes(const vector<tuple<string, string, int>>& routes) {
+    MetricTimer timer(MetricOp::UpdateRoutes);
+    unique_lock<shared_mutex> lock(graphMutex);
+    vector<RouteRecord> changed;
+    changed.reserve(routes.size());
+    size_t skipped = 0;
+    for (const auto& [city1, city2, distance] : routes) {
+        if (distance <= 0 || !graph.updateEdge(city1, city2, distance)) {
+            skipped++;
+            continue;
+        }
+        changed.push_back({graph.findCity(city1), graph.findCity(city2), distance});
+    }
+    if (!changed.empty()) {
+        dropTrees();
+        if (hierarchy && !hierarchy->updateWeights(changed)) hierarchy.reset();
+    }
+
+    OperationResult res;
+    res.success = skipped == 0;
+    res.message = "Routes updated: " + to_string(changed.size());
+    if (skipped > 0) {
+        timer.fail(MetricOutcome::NoRoute);
+        res.message += " (" + to_string(skipped) + " not found or invalid)";
+    }
+    return res;
+}
+
+JournalResult PathFinder::applyChanges(const vector<RouteChange>& changes) {
+    MetricTimer timer(MetricOp::ApplyChanges);
+    unique_lock<shared_mutex> lock(graphMutex);
+    JournalResult res{true, journalSeq, 0, 0, 0, ""};
+    vector<const RouteChange*> todo = RouteJournal::pending(changes, journalSeq, res.skipped);
+    if (todo.size() > MAX_REPAIRED_CHANGES) dropTrees();
+
+    string firstError;
+    for (const RouteChange* change : todo) {
+        // A sequence number repeated within the batch counts once
+        if (change->sequence <= journalSeq) {
+            res.skipped++;
+            continue;
+        }
+        journalSeq = change->sequence;
+        const string& city1 = change->city1;
+        const string& city2 = change->city2;
+        bool removal = change->kind == RouteChangeKind::Remove;
+        if (city1.empty() || city2.empty() || (!removal && change->distance <= 0)) {
+            if (res.rejected++ == 0) {
+                firstError = "change " + to_string(change->sequence) + " (" + RouteJournal::nameOf(change->kind) +
+                             "): " + (city1.empty() || city2.empty() ? "missing city name" : "distance must be positive");
+            }
+            continue;
+        }
+
+        // Applied as the state it leaves, so a replayed change is a no-op
+        res.applied++;
+        int oldWeight = graph.getEdgeWeight(city1, city2);
+        int newWeight = removal ? -1 : change->distance;
+        if (oldWeight == newWeight) continue;
+        if (removal) graph.removeEdge(city1, city2);
+        else graph.addEdge(city1, city2, newWeight);
+        repairTrees(city1, city2, oldWeight, newWeight);
+        updateHierarchy(city1, city2, newWeight);
+    }
+
+    res.sequence = journalSeq;
+    res.message = "Changes applied: " + to_string(res.applied) + ", up to sequence " + to_string(journalSeq);
+    if (res.skipped > 0) res.message += " (" + to_string(res.skipped) + " already applied)";
+    if (res.rejected > 0) {
+        timer.fail(MetricOutcome::InvalidInput);
+        res.success = false;
+        res.message += "; " + to_string(res.rejected) + " rejected, first: " + firstError;
+    }
+    return res;
+}
+
+int64_t PathFinder::journalSequence() {
+    shared_lock<shared_mutex> lock(graphMutex);
+    return journalSeq;
+}
+
+void PathFinder::setJournalSequence(int64_t sequence) {
+    unique_lock<shared_mutex> lock(graphMutex);
+    journalSeq = sequence;
+}
+
+OperationResult PathFinder::buildHierarchy() {
+    MetricTimer timer(MetricOp::BuildHierarchy);
+    unique_lock<shared_mutex> lock(graphMutex);
+    hierarchy.reset(new CustomizableHierarchy(graph));
+    OperationResult res;
+    res.success = true;
+    res.message = "Hierarchy built: " + to_string(hierarchy->arcCount()) + " arcs (" +
+                  to_string(hierarchy->shortcutCount()) + " shortcuts), height " +
+                  to_string(hierarchy->height()) + ".";
+    return res;
+}
+
+OperationResult PathFinder::reorder(string method) {
+    MetricTimer timer(MetricOp::Reorder);
+    unique_lock<shared_mutex> lock(graphMutex);
+    OperationResult res;
+    vector<int> order;
+    if (!GraphOrder::compute(graph, method, order)) {
+        timer.fail(MetricOutcome::InvalidInput);
+        res.success = false;
+        res.message = "Unknown order: " + method + " (use rcm, bfs or degree).";
+        return res;
+    }
+    double before = GraphOrder::meanGap(graph);
+    bool compressed = graph.isCompressed();
+    graph.renumber(order);
+    if (compressed) graph.compress();
+    dropTrees();
+    if (hierarchy) hierarchy.reset(new CustomizableHierarchy(graph));
+
+    res.success = true;
+    res.message = "Cities renumbered (" + method + "), mean id gap across a route " +
+                  to_string(llround(before)) + " to " + to_string(llround(GraphOrder::meanGap(graph))) + ".";
+    return res;
+}
+
+OperationResult PathFinder::compress() {
+    MetricTimer timer(MetricOp::Compress);
+    unique_lock<shared_mutex> lock(graphMutex);
+    pair<size_t, size_t> bytes = graph.compress();
+    OperationResult res;
+    res.success = true;
+    res.message = "Routes compressed from " + to_string(bytes.first) + " to " + to_string(bytes.second) +
+                  " bytes (" + CompressedAdjacency::decoderName() + " decoder).";
+    return res;
+}
+
+bool PathFinder::isCompressed() {
+    shared_lock<shared_mutex> lock(graphMutex);
+    return graph.isCompressed();
+}
+
+bool PathFinder::hasHierarchy() {
+    shared_lock<shared_mutex> lock(graphMutex);
+    return hierarchy != nullptr;
+}
+
 ShortestPathResult PathFinder::findShortestPath(string start, string end) {
-    return ShortestPath::find(graph, start, end);
+    MetricTimer timer(MetricOp::FindShortestPath);
+    shared_lock<shared_mutex> lock(graphMutex);
+    SearchStats stats;
+    SearchStats* target = statsTarget(stats);
+    ShortestPathResult res;
+    if (hierarchy) {
+        res = hierarchy->query(graph, start, end, target);
+    } else {
+        // Search counters of a tree hit are non-zero only when it was built
+        shared_ptr<const ShortestPathTree> tree;
+        if (graph.hasNode(start) && graph.hasNode(end)) tree = treeFor(graph.findCity(start), target);
+        if (tree) res = tree->query(graph, graph.findCity(end));
+        else res = ShortestPath::find(graph, start, end, target);
+    }
+    if (!res.found) timer.fail(missOutcome({start, end}));
+    res.stats = move(stats);
+    return res;
 }
 
 LongestPathResult PathFinder::findLongestPath(string start, string end) {
-    return LongestPath::find(graph, start, end);
+    MetricTimer timer(MetricOp::FindLongestPath);
+    shared_lock<shared_mutex> lock(graphMutex);
+    SearchStats stats;
+    LongestPathResult res = LongestPath::find(graph, start, end, statsTarget(stats));
+    if (!res.found) {
+        timer.fail(start == end ? MetricOutcome::InvalidInput : missOutcome({start, end}));
+    }
+    res.stats = move(stats);
+    return res;
 }
 
 FewestStopsResult PathFinder::findFewestStops(string start, string end) {
-    return FewestStops::find(graph, start, end);
+    MetricTimer timer(MetricOp::FindFewestStops);
+    shared_lock<shared_mutex> lock(graphMutex);
+    SearchStats stats;
+    FewestStopsResult res = FewestStops::find(graph, start, end, statsTarget(stats));
+    if (!res.found) timer.fail(missOutcome({start, end}));
+    res.stats = move(stats);
+    return res;
+}
+
+ShortestPathResult PathFinder::findShortestPathWithMaxStops(string start, string end, int maxStops) {
+    MetricTimer timer(MetricOp::FindShortestPathWithMaxStops);
+    shared_lock<shared_mutex> lock(graphMutex);
+    SearchStats stats;
+    ShortestPathResult res = MaxStopsPath::find(graph, start, end, maxStops, statsTarget(stats));
+    if (!res.found) timer.fail(maxStops < 0 ? MetricOutcome::InvalidInput : missOutcome({start, end}));
+    res.stats = move(stats);
+    return res;
+}
+
+StopsFrontResult PathFinder::findStopsParetoFront(string start, string end, int maxStops) {
+    MetricTimer timer(MetricOp::FindStopsParetoFront);
+    shared_lock<shared_mutex> lock(graphMutex);
+    SearchStats stats;
+    StopsFrontResult res = MaxStopsPath::front(graph, start, end, maxStops, statsTarget(stats));
+    if (!res.found) timer.fail(maxStops < 0 ? MetricOutcome::InvalidInput : missOutcome({start, end}));
+    res.stats = move(stats);
+    return res;
+}
+
+PathListResult PathFinder::findKShortestPaths(string start, string end, int k) {
+    MetricTimer timer(MetricOp::FindKShortestPaths);
+    shared_lock<shared_mutex> lock(graphMutex);
+    SearchStats stats;
+    PathListResult res = KShortestPaths::find(graph, start, end, k, statsTarget(stats));
+    if (!res.found) timer.fail(k < 1 ? MetricOutcome::InvalidInput : missOutcome({start, end}));
+    res.stats = move(stats);
+    return res;
+}
+
+PathListResult PathFinder::findAlternativeRoutes(string start, string end, int maxRoutes,
+                                                 double maxStretch, double maxOverlap,
+                                                 double minLocalOptimality) {
+    MetricTimer timer(MetricOp::FindAlternativeRoutes);
+    shared_lock<shared_mutex> lock(graphMutex);
+    SearchStats stats;
+    PathListResult res = AlternativeRoutes::find(graph, start, end, maxRoutes, maxStretch, maxOverlap,
+                                                 minLocalOptimality, statsTarget(stats));
+    if (!res.found) {
+        bool valid = AlternativeRoutes::validLimits(maxRoutes, maxStretch, maxOverlap, minLocalOptimality);
+        timer.fail(valid ? missOutcome({start, end}) : MetricOutcome::InvalidInput);
+    }
+    res.stats = move(stats);
+    return res;
 }
 
 vector<string> PathFinder::findReachableCities(string start) {
+    MetricTimer timer(MetricOp::FindReachableCities);
+    shared_lock<shared_mutex> lock(graphMutex);
+    if (!graph.hasNode(start)) timer.fail(MetricOutcome::UnknownCity);
     return ReachableCities::find(graph, start);
 }
 
+ComponentsResult PathFinder::connectedComponents() {
+    MetricTimer timer(MetricOp::ConnectedComponents);
+    shared_lock<shared_mutex> lock(graphMutex);
+    SearchStats stats;
+    ComponentsResult res = ConnectedComponents::label(graph, workers(), statsTarget(stats));
+    res.stats = move(stats);
+    return res;
+}
+
+CitiesWithinResult PathFinder::citiesWithin(string start, int maxDistance) {
+    MetricTimer timer(MetricOp::CitiesWithin);
+    shared_lock<shared_mutex> lock(graphMutex);
+    SearchStats stats;
+    CitiesWithinResult res = CitiesWithin::byDistance(graph, start, maxDistance, statsTarget(stats));
+    if (!res.found) timer.fail(maxDistance < 0 ? MetricOutcome::InvalidInput : MetricOutcome::UnknownCity);
+    res.stats = move(stats);
+    return res;
+}
+
+CitiesWithinResult PathFinder::citiesWithinStops(string start, int maxStops) {
+    MetricTimer timer(MetricOp::CitiesWithinStops);
+    shared_lock<shared_mutex> lock(graphMutex);
+    SearchStats stats;
+    CitiesWithinResult res = CitiesWithin::byStops(graph, start, maxStops, statsTarget(stats));
+    if (!res.found) timer.fail(maxStops < 0 ? MetricOutcome::InvalidInput : MetricOutcome::UnknownCity);
+    res.stats = move(stats);
+    return res;
+}
+
+IsochroneResult PathFinder::isochroneBands(string start, vector<int> radii, bool parallel) {
+    MetricTimer timer(MetricOp::IsochroneBands);
+    shared_lock<shared_mutex> lock(graphMutex);
+    SearchStats stats;
+    bool valid = !radii.empty() && *min_element(radii.begin(), radii.end()) >= 0;
+    IsochroneResult res = CitiesWithin::bands(graph, start, move(radii), statsTarget(stats),
+                                              parallel ? &workers() : nullptr);
+    if (!res.found) timer.fail(valid ? MetricOutcome::UnknownCity : MetricOutcome::InvalidInput);
+    res.stats = move(stats);
+    return res;
+}
+
+CitiesWithinResult PathFinder::nearestCities(string start, int k, vector<string> candidates,
+                                             function<bool(string_view)> filter) {
+    MetricTimer timer(MetricOp::NearestCities);
+    shared_lock<shared_mutex> lock(graphMutex);
+    SearchStats stats;
+    CitiesWithinResult res = NearestCities::find(graph, start, k, candidates, filter, statsTarget(stats));
+    if (!res.found) timer.fail(k < 1 ? MetricOutcome::InvalidInput : MetricOutcome::UnknownCity);
+    res.stats = move(stats);
+    return res;
+}
+
+DistanceMatrixResult PathFinder::distanceMatrix(vector<string> cities, bool withNextHop) {
+    MetricTimer timer(MetricOp::DistanceMatrix);
+    shared_lock<shared_mutex> lock(graphMutex);
+    SearchStats stats;
+    DistanceMatrixResult res = AllPairs::distances(graph, cities, withNextHop, workers(), statsTarget(stats));
+    if (!res.found) {
+        MetricOutcome outcome = missOutcome(cities);
+        timer.fail(outcome == MetricOutcome::UnknownCity ? outcome : MetricOutcome::InvalidInput);
+    }
+    res.stats = move(stats);
+    return res;
+}
+
+CitiesWithinResult PathFinder::distancesFrom(string start) {
+    MetricTimer timer(MetricOp::DistancesFrom);
+    shared_lock<shared_mutex> lock(graphMutex);
+    SearchStats stats;
+    CitiesWithinResult res = DeltaStepping::allFrom(graph, start, workers(), statsTarget(stats));
+    if (!res.found) timer.fail(MetricOutcome::UnknownCity);
+    res.stats = move(stats);
+    return res;
+}
+
+DistanceTableResult PathFinder::distanceTable(vector<string> sources, vector<string> targets) {
+    MetricTimer timer(MetricOp::DistanceTable);
+    shared_lock<shared_mutex> lock(graphMutex);
+    SearchStats stats;
+    DistanceTableResult res = DeltaStepping::table(graph, sources, targets, workers(), statsTarget(stats));
+    if (!res.found) {
+        vector<string> cities = sources;
+        cities.insert(cities.end(), targets.begin(), targets.end());
+        MetricOutcome outcome = missOutcome(cities);
+        timer.fail(outcome == MetricOutcome::UnknownCity ? outcome : MetricOutcome::InvalidInput);
+    }
+    res.stats = move(stats);
+    return res;
+}
+
 TourResult PathFinder::planMultiCityTour(vector<string> cities) {
-    return MultiCityTour::plan(graph, cities);
+    MetricTimer timer(MetricOp::PlanMultiCityTour);
+    shared_lock<shared_mutex> lock(graphMutex);
+    SearchStats stats;
+    TourResult res = MultiCityTour::plan(graph, cities, statsTarget(stats));
+    if (!res.found) timer.fail(cities.empty() ? MetricOutcome::InvalidInput : missOutcome(cities));
+    res.stats = move(stats);
+    return res;
 }
 
 MSTResult PathFinder::findCheapestNetwork() {
-    return CheapestNetwork::find(graph);
+    MetricTimer timer(MetricOp::FindCheapestNetwork);
+    shared_lock<shared_mutex> lock(graphMutex);
+    SearchStats stats;
+    MSTResult res = CheapestNetwork::find(graph, statsTarget(stats));
+    if (!res.found) timer.fail(MetricOutcome::NoRoute);
+    res.stats = move(stats);
+    return res;
 }
 
 vector<string> PathFinder::getAllCities() {
+    MetricTimer timer(MetricOp::GetAllCities);
+    shared_lock<shared_mutex> lock(graphMutex);
     return graph.getNodes();
 }
 
 vector<tuple<string, string, int>> PathFinder::getAllRoutes() {
+    MetricTimer timer(MetricOp::GetAllRoutes);
+    shared_lock<shared_mutex> lock(graphMutex);
     auto edges = graph.getAllEdges();
     vector<tuple<string, string, int>> result;
     for (size_t i = 0; i < edges.size(); ++i) {
@@ -85,5 +473,192 @@ vector<tuple<string, string, int>> PathFinder::getAllRoutes() {
 }
 
 void PathFinder::clearAll() {
+    MetricTimer timer(MetricOp::ClearAll);
+    unique_lock<shared_mutex> lock(graphMutex);
     graph.clear();
+    dropTrees();
+    hierarchy.reset();
+    journalSeq = 0;
+}
+
+bool PathFinder::hasCity(const string& city) {
+    shared_lock<shared_mutex> lock(graphMutex);
+    return graph.hasNode(city);
+}
+
+int PathFinder::cityCount() {
+    shared_lock<shared_mutex> lock(graphMutex);
+    return graph.getCityCount();
+}
+
+size_t PathFinder::routeCount() {
+    shared_lock<shared_mutex> lock(graphMutex);
+    return graph.getRouteCount();
+}
+
+void PathFinder::exportNames(vector<uint8_t>& bytes, vector<int64_t>& offsets) const {
+    MetricTimer timer(MetricOp::ExportNames);
+    shared_lock<shared_mutex> lock(graphMutex);
+    bytes.resize(graph.nameBytesSize());
+    offsets.resize(graph.idCount() + 1);
+    graph.exportNames(reinterpret_cast<char*>(bytes.data()), offsets.data());
+}
+
+void PathFinder::exportRoutes(vector<int32_t>& source, vector<int32_t>& target, vector<int32_t>& weight) const {
+    MetricTimer timer(MetricOp::ExportRoutes);
+    shared_lock<shared_mutex> lock(graphMutex);
+    size_t n = graph.getRouteCount();
+    source.resize(n);
+    target.resize(n);
+    weight.resize(n);
+    graph.exportRoutes(source.data(), target.data(), weight.data());
+}
+
+int PathFinder::cityId(const string& name) const {
+    shared_lock<shared_mutex> lock(graphMutex);
+    return graph.findCity(name);
+}
+
+vector<int32_t> PathFinder::cityIds(const vector<string>& names) const {
+    MetricTimer timer(MetricOp::CityIds);
+    shared_lock<shared_mutex> lock(graphMutex);
+    vector<int32_t> ids(names.size());
+    for (size_t i = 0; i < names.size(); ++i) ids[i] = graph.findCity(names[i]);
+    return ids;
+}
+
+OperationResult PathFinder::save(string path) {
+    MetricTimer timer(MetricOp::Save);
+    shared_lock<shared_mutex> lock(graphMutex);
+    OperationResult res;
+    string error;
+    if (!graph.saveSnapshot(path, error, journalSeq)) {
+        timer.fail(MetricOutcome::IoError);
+        res.success = false;
+        res.message = error;
+        return res;
+    }
+    res.success = true;
+    res.message = "Snapshot saved: " + to_string(graph.getCityCount()) + " cities, " +
+                  to_string(graph.getRouteCount()) + " routes.";
+    return res;
+}
+
+OperationResult PathFinder::load(string path, bool verify) {
+    MetricTimer timer(MetricOp::Load);
+    unique_lock<shared_mutex> lock(graphMutex);
+    OperationResult res;
+    string error;
+    int64_t sequence = 0;
+    if (!graph.loadSnapshot(path, error, verify, &sequence)) {
+        timer.fail(MetricOutcome::IoError);
+        res.success = false;
+        res.message = error;
+        return res;
+    }
+    dropTrees();
+    hierarchy.reset();
+    journalSeq = sequence;
+    res.success = true;
+    res.message = "Snapshot loaded: " + to_string(graph.getCityCount()) + " cities, " +
+                  to_string(graph.getRouteCount()) + " routes.";
+    return res;
+}
+
+ThreadPool& PathFinder::workers() {
+    call_once(poolOnce, [this] { pool.reset(new ThreadPool()); });
+    return *pool;
+}
+
+void PathFinder::submit(function<void()> work) {
+    workers().submit(move(work));
+}
+
+SearchStats* PathFinder::statsTarget(SearchStats& stats) const {
+    if (!collectStats.load(memory_order_relaxed)) return nullptr;
+    stats.collected = true;
+    return &stats;
+}
+
+// Caller holds graphMutex; a failed lookup means an endpoint is unknown or
+// the two are not connected
+MetricOutcome PathFinder::missOutcome(const vector<string>& cities) {
+    for (const auto& city : cities) {
+        if (!graph.hasNode(city)) return MetricOutcome::UnknownCity;
+    }
+    return MetricOutcome::NoRoute;
+}
+
+// Caller holds graphMutex (shared is enough: trees are only repaired under
+// the exclusive lock, so a tree handed out here stays valid for the query)
+shared_ptr<const ShortestPathTree> PathFinder::treeFor(int source, SearchStats* stats) {
+    {
+        lock_guard<mutex> lock(cacheMutex);
+        for (size_t i = 0; i < treeCache.size(); ++i) {
+            if (treeCache[i]->getSource() == source) {
+                // Move to the back so the least recently used tree is evicted first
+                shared_ptr<ShortestPathTree> hit = treeCache[i];
+                treeCache.erase(treeCache.begin() + i);
+                treeCache.push_back(hit);
+                return hit;
+            }
+        }
+
+        // A one-to-all tree costs a full search and a repair on every
+        // mutation; only sources that keep coming back earn one
+        if (count(recentSources.begin(), recentSources.end(), source) + 1 < TREE_AFTER_QUERIES) {
+            if (recentSources.size() < RECENT_SOURCES) recentSources.push_back(source);
+            else recentSources[recentNext++ % RECENT_SOURCES] = source;
+            return nullptr;
+        }
+        replace(recentSources.begin(), recentSources.end(), source, -1);
+    }
+
+    // Build outside the cache lock; a concurrent miss on the same source
+    // just builds the same tree twice
+    auto built = make_shared<ShortestPathTree>(graph, source, stats);
+
+    lock_guard<mutex> lock(cacheMutex);
+    for (const auto& tree : treeCache) {
+        if (tree->getSource() == source) return tree;
+    }
+    if (treeCache.size() >= MAX_CACHED_TREES) {
+        treeCache.erase(treeCache.begin());
+    }
+    treeCache.push_back(built);
+    return built;
+}
+
+// Caller holds graphMutex exclusively
+void PathFinder::repairTrees(const string& city1, const string& city2, int oldWeight, int newWeight) {
+    lock_guard<mutex> lock(cacheMutex);
+    if (treeCache.empty() || oldWeight == newWeight) return;
+
+    int u = graph.findCity(city1);
+    int v = graph.findCity(city2);
+
+    for (auto it = treeCache.begin(); it != treeCache.end(); ) {
+        // A source that lost its last route is no longer a city
+        if (!graph.isCity((*it)->getSource())) {
+            it = treeCache.erase(it);
+            continue;
+        }
+        (*it)->edgeChanged(graph, u, v, oldWeight, newWeight);
+        ++it;
+    }
+}
+
+// Also forgets the recent sources, whose ids may be reassigned
+void PathFinder::dropTrees() {
+    lock_guard<mutex> lock(cacheMutex);
+    treeCache.clear();
+    recentSources.clear();
+    recentNext = 0;
+}
+
+// Caller holds graphMutex exclusively; newWeight -1 for a removed route
+void PathFinder::updateHierarchy(const string& city1, const string& city2, int newWeight) {
+    if (hierarchy && !hierarchy->updateWeight(graph.findCity(city1), graph.findCity(city2), newWeight)) {
+        hierarchy.reset();
+    }
 }
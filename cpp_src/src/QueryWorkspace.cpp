@@ -0,0 +1,44 @@
+#include "../include/QueryWorkspace.h"
+#include <algorithm>
+
+QueryWorkspace& QueryWorkspace::acquire(int ids, int slot) {
+    thread_local QueryWorkspace workspaces[SLOTS];
+    QueryWorkspace& workspace = workspaces[slot];
+    workspace.reset(ids);
+    return workspace;
+}
+
+void QueryWorkspace::reset(int ids) {
+    if ((int)reachStamp.size() < ids) {
+        reachStamp.resize(ids, 0);
+        visitStamp.resize(ids, 0);
+        boundStamp.resize(ids, 0);
+        hopStamp.resize(ids, 0);
+        distance.resize(ids);
+        parent.resize(ids);
+        bounds.resize(ids);
+        hopCounts.resize(ids);
+    }
+
+    // Stamp 0 means "never written"; on wrap-around clear it for real
+    if (++generation == 0) {
+        fill(reachStamp.begin(), reachStamp.end(), 0);
+        fill(visitStamp.begin(), visitStamp.end(), 0);
+        fill(boundStamp.begin(), boundStamp.end(), 0);
+        fill(hopStamp.begin(), hopStamp.end(), 0);
+        generation = 1;
+    }
+
+    heap.clear();
+    frontier.clear();
+    path.clear();
+}
+
+vector<string> QueryWorkspace::pathTo(const Graph& g, int id) const {
+    vector<string> result;
+    for (int curr = id; curr != -1; curr = parent[curr]) {
+        result.emplace_back(g.nameOf(curr));
+    }
+    reverse(result.begin(), result.end());
+    return result;
+}
@@ -1,39 +1,38 @@
 #include "../include/ReachableCities.h"
-#include <map>
+#include "../include/QueryWorkspace.h"
+#include "../include/SearchStats.h"
 
 vector<string> ReachableCities::find(Graph& g, string start) {
     vector<string> reachable;
-    
+    PhaseTimer phases(nullptr); // trace spans only
+    phases.mark("resolve");
+
     // Check if start city exists
-    auto nodes = g.getNodes();
-    bool exists = false;
-    for (const auto& n : nodes) {
-        if (n == start) {
-            exists = true;
-            break;
-        }
-    }
-    if (!exists) return reachable;
-
-    map<string, bool> visited;
-    CustomStack<string> s; // Using Person 1's Stack for DFS
-    s.push(start);
-
-    while (!s.empty()) {
-        string u = s.top(); 
-        s.pop();
-        
-        if (!visited[u]) {
-            visited[u] = true;
-            
+    if (!g.hasNode(start)) return reachable;
+
+    int source = g.findCity(start);
+
+    // DFS; frontier is the stack
+    phases.mark("workspace");
+    QueryWorkspace& ws = QueryWorkspace::acquire(g.idCount());
+    ws.frontier.push_back(source);
+
+    phases.mark("search");
+    while (!ws.frontier.empty()) {
+        int u = ws.frontier.back();
+        ws.frontier.pop_back();
+
+        if (!ws.visited(u)) {
+            ws.visit(u);
+
             // Add to list if it's not the starting city
-            if (u != start) {
-                reachable.push_back(u);
+            if (u != source) {
+                reachable.emplace_back(g.nameOf(u));
             }
-            
-            for (const auto& e : g.getNeighbors(u)) {
-                if (!visited[e.dest]) {
-                    s.push(e.dest);
+
+            for (const Arc& arc : g.neighbors(u)) {
+                if (!ws.visited(arc.to)) {
+                    ws.frontier.push_back(arc.to);
                 }
             }
         }
@@ -0,0 +1,32 @@
+#include "../include/RouteJournal.h"
+#include <algorithm>
+
+bool RouteJournal::kindNamed(const string& name, RouteChangeKind& kind) {
+    if (name == "add") kind = RouteChangeKind::Add;
+    else if (name == "update") kind = RouteChangeKind::Update;
+    else if (name == "remove") kind = RouteChangeKind::Remove;
+    else return false;
+    return true;
+}
+
+const char* RouteJournal::nameOf(RouteChangeKind kind) {
+    switch (kind) {
+        case RouteChangeKind::Add: return "add";
+        case RouteChangeKind::Update: return "update";
+        case RouteChangeKind::Remove: return "remove";
+    }
+    return "";
+}
+
+vector<const RouteChange*> RouteJournal::pending(const vector<RouteChange>& changes, int64_t since,
+                                                 long long& skipped) {
+    vector<const RouteChange*> out;
+    out.reserve(changes.size());
+    for (const RouteChange& change : changes) {
+        if (change.sequence > since) out.push_back(&change);
+    }
+    skipped = (long long)(changes.size() - out.size());
+    stable_sort(out.begin(), out.end(),
+                [](const RouteChange* a, const RouteChange* b) { return a->sequence < b->sequence; });
+    return out;
+}
@@ -0,0 +1,168 @@
+#include "../include/RouteLoader.h"
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include <fstream>
+
+namespace {
+
+string trim(const string& s) {
+    size_t b = s.find_first_not_of(" \t\r\n");
+    if (b == string::npos) return "";
+    size_t e = s.find_last_not_of(" \t\r\n");
+    return s.substr(b, e - b + 1);
+}
+
+} // namespace
+
+RouteLoader::RouteLoader(Graph& g) : graph(g), started(chrono::steady_clock::now()) {}
+
+void RouteLoader::reject(const string& reason) {
+    rowsRejected++;
+    if (firstError.empty()) {
+        firstError = "row " + to_string(rowsRead) + ": " + reason;
+    }
+}
+
+bool RouteLoader::add(const string& u, const string& v, int w) {
+    rowsRead++;
+    if (u.empty() || v.empty()) {
+        reject("missing city name");
+        return false;
+    }
+    if (w <= 0) {
+        reject("distance must be positive");
+        return false;
+    }
+
+    buffer.push_back({graph.internCity(u), graph.internCity(v), w});
+    return true;
+}
+
+void RouteLoader::addColumns(const vector<string>& names, const int32_t* source, const int32_t* target,
+                             const int32_t* weight, size_t count) {
+    // Intern every name once; rows then only carry ids
+    vector<int> ids(names.size(), -1);
+    for (size_t i = 0; i < names.size(); ++i) {
+        if (!names[i].empty()) ids[i] = graph.internCity(names[i]);
+    }
+
+    buffer.reserve(buffer.size() + count);
+    for (size_t i = 0; i < count; ++i) {
+        rowsRead++;
+        int32_t s = source[i], t = target[i];
+        if (s < 0 || t < 0 || (size_t)s >= names.size() || (size_t)t >= names.size()) {
+            reject("city index out of range");
+            continue;
+        }
+        if (ids[s] == -1 || ids[t] == -1) {
+            reject("missing city name");
+            continue;
+        }
+        if (weight[i] <= 0) {
+            reject("distance must be positive");
+            continue;
+        }
+        buffer.push_back({ids[s], ids[t], weight[i]});
+    }
+}
+
+void RouteLoader::splitFields(const string& line, char delim, vector<string>& fields) {
+    fields.clear();
+    string field;
+    bool quoted = false;
+
+    for (size_t i = 0; i < line.size(); ++i) {
+        char c = line[i];
+        if (quoted) {
+            if (c == '"' && i + 1 < line.size() && line[i + 1] == '"') {
+                field += '"';
+                ++i;
+            } else if (c == '"') {
+                quoted = false;
+            } else {
+                field += c;
+            }
+        } else if (c == '"') {
+            quoted = true;
+        } else if (c == delim) {
+            fields.push_back(trim(field));
+            field.clear();
+        } else {
+            field += c;
+        }
+    }
+    fields.push_back(trim(field));
+}
+
+bool RouteLoader::parseDistance(const string& field, int& out) {
+    if (field.empty()) return false;
+    errno = 0;
+    char* end = nullptr;
+    long value = strtol(field.c_str(), &end, 10);
+    if (errno != 0 || *end != '\0' || value < INT_MIN || value > INT_MAX) return false;
+    out = (int)value;
+    return true;
+}
+
+bool RouteLoader::addLine(const string& line) {
+    string row = trim(line);
+    if (row.empty() || row[0] == '#') return true;
+
+    bool firstRow = delimiter == 0;
+    if (firstRow) delimiter = row.find('\t') != string::npos ? '\t' : ',';
+
+    vector<string> fields;
+    splitFields(row, delimiter, fields);
+
+    int w = 0;
+    bool numeric = fields.size() == 3 && parseDistance(fields[2], w);
+    if (firstRow && fields.size() == 3 && !numeric) return true; // header row
+
+    if (!numeric) {
+        rowsRead++;
+        reject(fields.size() != 3 ? "expected 3 fields, got " + to_string(fields.size())
+                                  : "distance '" + fields[2] + "' is not an integer");
+        return false;
+    }
+    return add(fields[0], fields[1], w);
+}
+
+BulkLoadResult RouteLoader::commit() {
+    BulkLoadResult res;
+    res.rowsRead = rowsRead;
+    res.rowsRejected = rowsRejected;
+    res.rowsAccepted = buffer.size();
+    res.duplicates = graph.mergeRoutes(buffer);
+
+    res.seconds = chrono::duration<double>(chrono::steady_clock::now() - started).count();
+    res.rowsPerSecond = res.seconds > 0 ? rowsRead / res.seconds : 0;
+    res.success = true;
+    res.message = "Loaded " + to_string(res.rowsAccepted) + " routes (" +
+                  to_string(res.rowsRejected) + " rejected, " +
+                  to_string(res.duplicates) + " duplicates) at " +
+                  to_string((long long)res.rowsPerSecond) + " rows/s.";
+    if (!firstError.empty()) res.message += " First rejection: " + firstError + ".";
+
+    buffer.clear();
+    rowsRead = 0;
+    rowsRejected = 0;
+    firstError.clear();
+    started = chrono::steady_clock::now();
+    return res;
+}
+
+BulkLoadResult RouteLoader::loadFile(Graph& g, const string& path) {
+    ifstream in(path);
+    if (!in) {
+        BulkLoadResult res = {false, 0, 0, 0, 0, 0.0, 0.0, "Cannot open '" + path + "'."};
+        return res;
+    }
+
+    RouteLoader loader(g);
+    string line;
+    while (getline(in, line)) {
+        loader.addLine(line);
+    }
+    return loader.commit();
+}
@@ -1,73 +1,64 @@
 #include "../include/ShortestPath.h"
-#include <map>
-#include <climits>
+#include "../include/QueryWorkspace.h"
 
-ShortestPathResult ShortestPath::find(Graph& g, string start, string end) {
+ShortestPathResult ShortestPath::find(Graph& g, string start, string end, SearchStats* stats) {
     ShortestPathResult res;
     res.found = false;
     res.distance = 0;
 
-    // Check if start and end cities exist in the graph
-    vector<string> allNodes = g.getNodes();
-    bool startExists = false, endExists = false;
-    for (const auto& n : allNodes) {
-        if (n == start) startExists = true;
-        if (n == end) endExists = true;
-    }
+    StatsProbe probe(stats);
+    PhaseTimer phases(stats);
+    phases.mark("resolve");
 
-    if (!startExists || !endExists) {
+    // Check if start and end cities exist in the graph
+    if (!g.hasNode(start) || !g.hasNode(end)) {
         res.message = "One or both cities not found in the network.";
         return res;
     }
 
-    map<string, int> dist;
-    map<string, string> parent;
-    for (const auto& city : allNodes) {
-        dist[city] = INT_MAX;
-    }
+    int source = g.findCity(start);
+    int target = g.findCity(end);
+
+    phases.mark("workspace");
+    // Only cities the search touches are initialized
+    QueryWorkspace& ws = QueryWorkspace::acquire(g.idCount());
+    ws.reach(source, 0, -1);
+    ws.heap.push(0, source);
+    probe.pushed();
 
-    MinPQ pq;
-    dist[start] = 0;
-    pq.push(0, start);
+    phases.mark("search");
+    while (!ws.heap.empty()) {
+        IdNode top = ws.heap.pop();
+        probe.popped();
 
-    while (!pq.empty()) {
-        PQNode top = pq.pop();
-        
-        if (top.weight > dist[top.city]) continue;
-        if (top.city == end) break;
+        if (top.weight > ws.dist(top.id)) {
+            probe.stale();
+            continue;
+        }
+        probe.settled();
+        if (top.id == target) break;
 
-        for (const auto& edge : g.getNeighbors(top.city)) {
-            int newDist = dist[top.city] + edge.weight;
-            
-            if (newDist < dist[edge.dest]) {
-                dist[edge.dest] = newDist;
-                parent[edge.dest] = top.city;
-                pq.push(newDist, edge.dest);
+        for (const Arc& arc : g.neighbors(top.id)) {
+            int newDist = top.weight + arc.weight;
+            probe.relaxed();
+
+            if (newDist < ws.dist(arc.to)) {
+                ws.reach(arc.to, newDist, top.id);
+                ws.heap.push(newDist, arc.to);
+                probe.pushed();
+                probe.frontier(ws.heap.size());
             }
         }
     }
 
-    if (dist[end] == INT_MAX) {
+    phases.mark("path");
+
+    if (!ws.reached(target)) {
         res.message = "No route exists between these cities.";
     } else {
         res.found = true;
-        res.distance = dist[end];
-        
-        // Reconstruct path using CustomStack
-        CustomStack<string> pathStack;
-        string curr = end;
-        while (curr != start) {
-            pathStack.push(curr);
-            curr = parent[curr];
-        }
-        pathStack.push(start);
-
-        // Transfer from stack to vector
-        while (!pathStack.empty()) {
-            res.path.push_back(pathStack.top());
-            pathStack.pop();
-        }
-        
+        res.distance = ws.dist(target);
+        res.path = ws.pathTo(g, target);
         res.message = "Shortest path found successfully.";
     }
 
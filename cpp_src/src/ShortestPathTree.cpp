@@ -0,0 +1,126 @@
+#include "../include/ShortestPathTree.h"
+#include <algorithm>
+#include <climits>
+
+ShortestPathTree::ShortestPathTree(const Graph& g, int source, SearchStats* stats) : source(source) {
+    StatsProbe probe(stats);
+    fit(g);
+    dist[source] = 0;
+    pq.push(0, source);
+    probe.pushed();
+    relax(g, probe);
+}
+
+void ShortestPathTree::fit(const Graph& g) {
+    if ((int)dist.size() >= g.idCount()) return;
+    dist.resize(g.idCount(), INT_MAX);
+    parent.resize(g.idCount(), -1);
+}
+
+// Dijkstra from whatever is already in the queue; entries whose key went
+// stale are skipped
+void ShortestPathTree::relax(const Graph& g, StatsProbe probe) {
+    while (!pq.empty()) {
+        IdNode top = pq.pop();
+        probe.popped();
+
+        if (top.weight > dist[top.id]) {
+            probe.stale();
+            continue;
+        }
+        probe.settled();
+
+        for (const Arc& arc : g.neighbors(top.id)) {
+            int newDist = top.weight + arc.weight;
+            probe.relaxed();
+
+            if (newDist < dist[arc.to]) {
+                dist[arc.to] = newDist;
+                parent[arc.to] = top.id;
+                pq.push(newDist, arc.to);
+                probe.pushed();
+                probe.frontier(pq.size());
+            }
+        }
+    }
+}
+
+// Edge (from -> to) got cheaper or appeared: only cities whose distance
+// actually improves are touched.
+void ShortestPathTree::decrease(const Graph& g, int from, int to, int w) {
+    if (dist[from] == INT_MAX) return;
+
+    int newDist = dist[from] + w;
+    if (newDist >= dist[to]) return;
+
+    dist[to] = newDist;
+    parent[to] = from;
+    pq.push(newDist, to);
+    relax(g);
+}
+
+// The tree edge into root got longer or vanished: every city below root may
+// have a worse distance now, nothing else can change. Tree edges are routes,
+// so a city's children are the neighbours whose parent it is.
+void ShortestPathTree::increase(const Graph& g, int root) {
+    vector<int> affected{root};
+    for (size_t i = 0; i < affected.size(); ++i) {
+        int u = affected[i];
+        for (const Arc& arc : g.neighbors(u)) {
+            if (parent[arc.to] == u) affected.push_back(arc.to);
+        }
+    }
+    for (int u : affected) {
+        dist[u] = INT_MAX;
+        parent[u] = -1;
+    }
+
+    // Seed each affected city with its best entry from the intact part of the tree
+    for (int u : affected) {
+        for (const Arc& arc : g.neighbors(u)) {
+            if (dist[arc.to] == INT_MAX) continue;
+            int candidate = dist[arc.to] + arc.weight;
+            if (candidate < dist[u]) {
+                dist[u] = candidate;
+                parent[u] = arc.to;
+            }
+        }
+        if (dist[u] != INT_MAX) pq.push(dist[u], u);
+    }
+    relax(g);
+}
+
+void ShortestPathTree::edgeChanged(const Graph& g, int u, int v, int oldWeight, int newWeight) {
+    if (oldWeight == newWeight) return;
+    fit(g);
+
+    if (newWeight != -1 && (oldWeight == -1 || newWeight < oldWeight)) {
+        decrease(g, u, v, newWeight);
+        decrease(g, v, u, newWeight);
+        return;
+    }
+
+    // Longer or removed: only matters if the edge carries part of the tree
+    if (parent[v] == u) increase(g, v);
+    else if (parent[u] == v) increase(g, u);
+}
+
+ShortestPathResult ShortestPathTree::query(const Graph& g, int target) const {
+    ShortestPathResult res;
+    res.found = false;
+    res.distance = 0;
+
+    if (distOf(target) == INT_MAX) {
+        res.message = "No route exists between these cities.";
+        return res;
+    }
+
+    res.found = true;
+    res.distance = dist[target];
+    for (int curr = target; curr != -1; curr = parent[curr]) {
+        res.path.emplace_back(g.nameOf(curr));
+    }
+    reverse(res.path.begin(), res.path.end());
+    res.message = "Shortest path found successfully.";
+    return res;
+}
@@ -0,0 +1,94 @@
+#include "../include/ThreadPool.h"
+#include <algorithm>
+#include <atomic>
+
+ThreadPool::ThreadPool(unsigned threads) : state(make_shared<State>()) {
+    if (threads == 0) threads = thread::hardware_concurrency();
+    if (threads == 0) threads = 1;
+
+    workers.reserve(threads);
+    for (unsigned i = 0; i < threads; ++i) {
+        workers.emplace_back(run, state);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        lock_guard<mutex> lock(state->m);
+        state->stopping = true;
+    }
+    state->ready.notify_all();
+
+    for (auto& worker : workers) {
+        if (worker.get_id() == this_thread::get_id()) worker.detach();
+        else worker.join();
+    }
+}
+
+void ThreadPool::submit(function<void()> task) {
+    {
+        lock_guard<mutex> lock(state->m);
+        state->tasks.push_back(move(task));
+    }
+    state->ready.notify_one();
+}
+
+void ThreadPool::parallelFor(size_t count, const function<void(size_t)>& body) {
+    struct Loop {
+        atomic<size_t> next{0};
+        mutex m;
+        condition_variable idle;
+        int active = 0;
+        bool closed = false; // set once the caller is done; late helpers just return
+        exception_ptr error; // first thrown by body
+    };
+    auto loop = make_shared<Loop>();
+    const function<void(size_t)>* work = &body;
+    auto drain = [loop, count, work]() {
+        try {
+            for (size_t i = loop->next++; i < count; i = loop->next++) (*work)(i);
+        } catch (...) {
+            lock_guard<mutex> lock(loop->m);
+            if (!loop->error) loop->error = current_exception();
+            loop->next = count; // nobody claims the indices left
+        }
+    };
+
+    size_t helpers = min<size_t>(workers.size(), count) - (count > 0 ? 1 : 0);
+    for (size_t h = 0; h < helpers; ++h) {
+        submit([loop, drain]() {
+            {
+                lock_guard<mutex> lock(loop->m);
+                if (loop->closed) return;
+                loop->active++;
+            }
+            drain();
+            {
+                lock_guard<mutex> lock(loop->m);
+                loop->active--;
+            }
+            loop->idle.notify_all();
+        });
+    }
+    drain();
+
+    unique_lock<mutex> lock(loop->m);
+    loop->closed = true;
+    loop->idle.wait(lock, [&] { return loop->active == 0; });
+    if (loop->error) rethrow_exception(loop->error);
+}
+
+// Queued work is drained before the workers exit
+void ThreadPool::run(shared_ptr<State> state) {
+    while (true) {
+        function<void()> task;
+        {
+            unique_lock<mutex> lock(state->m);
+            state->ready.wait(lock, [&] { return state->stopping || !state->tasks.empty(); });
+            if (state->tasks.empty()) return;
+            task = move(state->tasks.front());
+            state->tasks.pop_front();
+        }
+        task();
+    }
+}
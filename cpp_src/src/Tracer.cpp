@@ -0,0 +1,139 @@
+#include "../include/Tracer.h"
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+namespace {
+
+// Per-thread request state: nesting depth, the sampling decision of the
+// outermost span and the events recorded since it opened
+struct ThreadTrace {
+    int depth = 0;
+    bool sampled = false;
+    vector<Tracer::Event> pending;
+    uint32_t id;
+    uint64_t rng;
+
+    ThreadTrace() {
+        static atomic<uint32_t> nextId{1};
+        id = nextId.fetch_add(1);
+        rng = 0x9E3779B97F4A7C15ull * id;
+    }
+
+    double uniform() { // xorshift64
+        rng ^= rng << 13;
+        rng ^= rng >> 7;
+        rng ^= rng << 17;
+        return (rng >> 11) * (1.0 / 9007199254740992.0);
+    }
+};
+
+ThreadTrace& threadTrace() {
+    thread_local ThreadTrace trace;
+    return trace;
+}
+
+} // namespace
+
+Tracer::Tracer() : epoch(chrono::steady_clock::now()) {}
+
+// Never destroyed, like Metrics::global()
+Tracer& Tracer::global() {
+    static Tracer* instance = new Tracer();
+    return *instance;
+}
+
+void Tracer::start(double sampleRate, size_t maxEvents) {
+    {
+        lock_guard<mutex> lock(eventsMutex);
+        capacity = maxEvents > 0 ? maxEvents : 1;
+        while (events.size() > capacity) events.pop_front();
+    }
+    rate.store(sampleRate);
+    on.store(true);
+}
+
+void Tracer::stop() {
+    on.store(false);
+}
+
+void Tracer::clear() {
+    lock_guard<mutex> lock(eventsMutex);
+    events.clear();
+}
+
+bool Tracer::sample() {
+    if (!enabled()) return false;
+    double r = rate.load(memory_order_relaxed);
+    return r >= 1.0 || (r > 0.0 && threadTrace().uniform() < r);
+}
+
+double Tracer::micros(chrono::steady_clock::time_point t) const {
+    return chrono::duration<double, micro>(t - epoch).count();
+}
+
+bool Tracer::recording() {
+    ThreadTrace& t = threadTrace();
+    return t.depth > 0 && t.sampled;
+}
+
+void Tracer::emit(const char* name, chrono::steady_clock::time_point start,
+                  chrono::steady_clock::time_point end) {
+    ThreadTrace& t = threadTrace();
+    if (t.depth == 0 || !t.sampled) return;
+    Tracer& tracer = global();
+    double begin = tracer.micros(start);
+    t.pending.push_back({name, "phase", begin, tracer.micros(end) - begin, t.id});
+}
+
+void Tracer::publish(vector<Event>& batch) {
+    lock_guard<mutex> lock(eventsMutex);
+    for (const auto& e : batch) events.push_back(e);
+    while (events.size() > capacity) events.pop_front();
+    batch.clear();
+}
+
+string Tracer::json() {
+    ostringstream out;
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    out << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"pathfinder\"}}";
+
+    lock_guard<mutex> lock(eventsMutex);
+    char buf[64];
+    for (const auto& e : events) {
+        out << ",\n{\"name\":\"" << e.name << "\",\"cat\":\"" << e.category << "\",\"ph\":\"X\"";
+        snprintf(buf, sizeof(buf), ",\"ts\":%.3f,\"dur\":%.3f", e.start, e.duration);
+        out << buf << ",\"pid\":1,\"tid\":" << e.thread << "}";
+    }
+    out << "\n]}\n";
+    return out.str();
+}
+
+bool Tracer::writeJson(const string& path, string& error) {
+    ofstream file(path);
+    if (!file) {
+        error = "Cannot write trace to '" + path + "'.";
+        return false;
+    }
+    file << json();
+    return true;
+}
+
+TraceSpan::TraceSpan(const char* name, const char* category) : name(name), category(category) {
+    ThreadTrace& t = threadTrace();
+    if (t.depth == 0) t.sampled = Tracer::global().sample();
+    t.depth++;
+    active = t.sampled;
+    if (active) started = Tracer::global().micros(chrono::steady_clock::now());
+}
+
+TraceSpan::~TraceSpan() {
+    ThreadTrace& t = threadTrace();
+    if (active) {
+        double ended = Tracer::global().micros(chrono::steady_clock::now());
+        t.pending.push_back({name, category, started, ended - started, t.id});
+    }
+    if (--t.depth == 0 && !t.pending.empty()) {
+        Tracer::global().publish(t.pending);
+    }
+}
@@ -1,8 +1,117 @@
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
+#include <pybind11/numpy.h>
+#include <climits>
 #include "cpp_src/include/PathFinder.h"
+#include "wrapper_util.h"
 
-namespace py = pybind11;
+namespace {
+
+// Journal rows as (sequence, "add" | "update" | "remove", city1, city2, distance)
+using ChangeRow = tuple<int64_t, string, string, string, int>;
+
+vector<RouteChange> changesFrom(const vector<ChangeRow>& rows) {
+    vector<RouteChange> changes;
+    changes.reserve(rows.size());
+    for (const auto& [sequence, kindName, city1, city2, distance] : rows) {
+        RouteChangeKind kind;
+        if (!RouteJournal::kindNamed(kindName, kind)) {
+            throw py::value_error("unknown change kind '" + kindName + "' at sequence " + to_string(sequence));
+        }
+        changes.push_back({sequence, kind, city1, city2, distance});
+    }
+    return changes;
+}
+
+// Row-major rows x cols matrix of a result, copied into a 2-D array
+py::array_t<int32_t> matrix(const vector<int>& values, size_t rows, size_t cols) {
+    py::array_t<int32_t> out({(py::ssize_t)rows, (py::ssize_t)cols});
+    copy(values.begin(), values.end(), out.mutable_data());
+    return out;
+}
+
+// Python object referenced from a worker thread; released with the GIL held
+class PyRef {
+    py::object obj;
+public:
+    explicit PyRef(py::object o) : obj(move(o)) {}
+    ~PyRef() {
+        py::gil_scoped_acquire gil;
+        obj = py::object();
+    }
+    const py::object& get() const { return obj; }
+};
+
+// From a coroutine the concurrent future is wrapped for the running loop,
+// so callers can simply await it
+py::object awaitable(py::object future) {
+    py::module_ asyncio = py::module_::import("asyncio");
+    try {
+        py::object loop = asyncio.attr("get_running_loop")();
+        return asyncio.attr("wrap_future")(future, py::arg("loop") = loop);
+    } catch (py::error_already_set& e) {
+        if (!e.matches(PyExc_RuntimeError)) throw;
+        return future;
+    }
+}
+
+// Runs call() without the GIL under a root trace span, then converts the
+// result under a span of its own so conversion cost shows in traces
+template <typename Call>
+py::object traced(const char* name, Call call) {
+    TraceSpan request(name, "python");
+    decltype(call()) result;
+    {
+        py::gil_scoped_release nogil;
+        result = call();
+    }
+    TraceSpan convert("pybind11.convert", "python");
+    return py::cast(move(result));
+}
+
+// Runs query(engine) on the engine's thread pool and resolves a Python future
+template <typename Query>
+py::object submitQuery(py::object self, Query query) {
+    PathFinder* engine = self.cast<PathFinder*>();
+    py::object future = py::module_::import("concurrent.futures").attr("Future")();
+    auto pending = make_shared<PyRef>(future);
+    auto owner = make_shared<PyRef>(self); // keeps the engine alive until the task ends
+
+    engine->submit([engine, pending, owner, query]() {
+        TraceSpan request("python.async_query", "python");
+        {
+            py::gil_scoped_acquire gil;
+            if (!pending->get().attr("set_running_or_notify_cancel")().cast<bool>()) return;
+        }
+
+        decltype(query(*engine)) result;
+        string error;
+        try {
+            result = query(*engine);
+        } catch (const exception& e) {
+            error = e.what();
+        }
+
+        py::gil_scoped_acquire gil;
+        try {
+            if (error.empty()) {
+                py::object value;
+                {
+                    TraceSpan convert("pybind11.convert", "python");
+                    value = py::cast(move(result));
+                }
+                pending->get().attr("set_result")(value);
+            } else {
+                pending->get().attr("set_exception")(py::reinterpret_borrow<py::object>(PyExc_RuntimeError)(error));
+            }
+        } catch (py::error_already_set& e) {
+            e.discard_as_unraisable("pathfinder async query");
+        }
+    });
+    return awaitable(future);
+}
+
+} // namespace
 
 PYBIND11_MODULE(pathfinder, m) {
     m.doc() = "Modular Path Finder Engine";
@@ -13,13 +122,34 @@ PYBIND11_MODULE(pathfinder, m) {
         .def_readwrite("success", &OperationResult::success)
         .def_readwrite("message", &OperationResult::message);
 
+    // SearchStats: per-query work counters, filled while collect_stats is on
+    py::class_<SearchStats>(m, "SearchStats")
+        .def(py::init<>())
+        .def_readonly("collected", &SearchStats::collected)
+        .def_readonly("nodesSettled", &SearchStats::nodesSettled)
+        .def_readonly("edgesRelaxed", &SearchStats::edgesRelaxed)
+        .def_readonly("heapPushes", &SearchStats::heapPushes)
+        .def_readonly("heapPops", &SearchStats::heapPops)
+        .def_readonly("staleSkipped", &SearchStats::staleSkipped)
+        .def_readonly("recursionNodes", &SearchStats::recursionNodes)
+        .def_readonly("peakFrontier", &SearchStats::peakFrontier)
+        .def_readonly("phases", &SearchStats::phases, "[(phase, milliseconds)] in execution order")
+        .def("__repr__", [](const SearchStats& s) {
+            return "<SearchStats settled=" + to_string(s.nodesSettled) +
+                   " relaxed=" + to_string(s.edgesRelaxed) +
+                   " pushes=" + to_string(s.heapPushes) +
+                   " recursion=" + to_string(s.recursionNodes) +
+                   " peakFrontier=" + to_string(s.peakFrontier) + ">";
+        });
+
     // ShortestPathResult structure
     py::class_<ShortestPathResult>(m, "ShortestPathResult")
         .def(py::init<>())
         .def_readwrite("found", &ShortestPathResult::found)
         .def_readwrite("path", &ShortestPathResult::path)
         .def_readwrite("distance", &ShortestPathResult::distance)
-        .def_readwrite("message", &ShortestPathResult::message);
+        .def_readwrite("message", &ShortestPathResult::message)
+        .def_readonly("stats", &ShortestPathResult::stats);
 
     // LongestPathResult structure
     py::class_<LongestPathResult>(m, "LongestPathResult")
@@ -27,7 +157,8 @@ PYBIND11_MODULE(pathfinder, m) {
         .def_readwrite("found", &LongestPathResult::found)
         .def_readwrite("path", &LongestPathResult::path)
         .def_readwrite("distance", &LongestPathResult::distance)
-        .def_readwrite("message", &LongestPathResult::message);
+        .def_readwrite("message", &LongestPathResult::message)
+        .def_readonly("stats", &LongestPathResult::stats);
 
     // FewestStopsResult
     py::class_<FewestStopsResult>(m, "FewestStopsResult")
@@ -35,7 +166,99 @@ PYBIND11_MODULE(pathfinder, m) {
         .def_readwrite("found", &FewestStopsResult::found)
         .def_readwrite("path", &FewestStopsResult::path)
         .def_readwrite("stops", &FewestStopsResult::stops)
-        .def_readwrite("message", &FewestStopsResult::message);
+        .def_readwrite("message", &FewestStopsResult::message)
+        .def_readonly("stats", &FewestStopsResult::stats);
+
+    // StopsFrontEntry / StopsFrontResult: distance against stops trade-off
+    py::class_<StopsFrontEntry>(m, "StopsFrontEntry")
+        .def(py::init<>())
+        .def_readwrite("stops", &StopsFrontEntry::stops)
+        .def_readwrite("distance", &StopsFrontEntry::distance)
+        .def_readwrite("path", &StopsFrontEntry::path);
+
+    py::class_<StopsFrontResult>(m, "StopsFrontResult")
+        .def(py::init<>())
+        .def_readwrite("found", &StopsFrontResult::found)
+        .def_readwrite("front", &StopsFrontResult::front)
+        .def_readwrite("message", &StopsFrontResult::message)
+        .def_readonly("stats", &StopsFrontResult::stats);
+
+    // PathListResult: several routes, shortest first
+    py::class_<PathListResult>(m, "PathListResult")
+        .def(py::init<>())
+        .def_readwrite("found", &PathListResult::found)
+        .def_readwrite("paths", &PathListResult::paths)
+        .def_readwrite("message", &PathListResult::message)
+        .def_readonly("stats", &PathListResult::stats);
+
+    // CityDistance / CitiesWithinResult / IsochroneResult: bounded searches
+    py::class_<CityDistance>(m, "CityDistance")
+        .def(py::init<>())
+        .def_readwrite("city", &CityDistance::city)
+        .def_readwrite("distance", &CityDistance::distance)
+        .def_readwrite("stops", &CityDistance::stops);
+
+    py::class_<CitiesWithinResult>(m, "CitiesWithinResult")
+        .def(py::init<>())
+        .def_readwrite("found", &CitiesWithinResult::found)
+        .def_readwrite("cities", &CitiesWithinResult::cities)
+        .def_readwrite("message", &CitiesWithinResult::message)
+        .def_readonly("stats", &CitiesWithinResult::stats);
+
+    // ComponentsResult: component (by city id, as from export_names) and
+    // sizes are fresh int32 arrays
+    py::class_<ComponentsResult>(m, "ComponentsResult")
+        .def(py::init<>())
+        .def_readwrite("found", &ComponentsResult::found)
+        .def_property_readonly("component",
+                               [](const ComponentsResult& r) {
+                                   return py::array_t<int32_t>(r.component.size(), r.component.data());
+                               })
+        .def_property_readonly("sizes",
+                               [](const ComponentsResult& r) {
+                                   return py::array_t<int32_t>(r.sizes.size(), r.sizes.data());
+                               })
+        .def_readwrite("message", &ComponentsResult::message)
+        .def_readonly("stats", &ComponentsResult::stats);
+
+    py::class_<IsochroneResult>(m, "IsochroneResult")
+        .def(py::init<>())
+        .def_readwrite("found", &IsochroneResult::found)
+        .def_readwrite("radii", &IsochroneResult::radii)
+        .def_readwrite("bands", &IsochroneResult::bands)
+        .def_readwrite("message", &IsochroneResult::message)
+        .def_readonly("stats", &IsochroneResult::stats);
+
+    // DistanceMatrixResult: each matrix property returns a fresh n x n array
+    py::class_<DistanceMatrixResult>(m, "DistanceMatrixResult")
+        .def(py::init<>())
+        .def_readwrite("found", &DistanceMatrixResult::found)
+        .def_readwrite("cities", &DistanceMatrixResult::cities)
+        .def_property_readonly("distances",
+                               [](const DistanceMatrixResult& r) { return matrix(r.distances, r.cities.size(), r.cities.size()); })
+        .def_property_readonly("next_hop",
+                               [](const DistanceMatrixResult& r) -> py::object {
+                                   if (r.nextHop.empty()) return py::none();
+                                   return matrix(r.nextHop, r.cities.size(), r.cities.size());
+                               })
+        .def("path", &AllPairs::path,
+             "Cities from row i to column j along next_hop; empty if unreachable",
+             py::arg("i"), py::arg("j"))
+        .def_readwrite("message", &DistanceMatrixResult::message)
+        .def_readonly("stats", &DistanceMatrixResult::stats);
+
+    // DistanceTableResult: distances is a fresh sources x targets array
+    py::class_<DistanceTableResult>(m, "DistanceTableResult")
+        .def(py::init<>())
+        .def_readwrite("found", &DistanceTableResult::found)
+        .def_readwrite("sources", &DistanceTableResult::sources)
+        .def_readwrite("targets", &DistanceTableResult::targets)
+        .def_property_readonly("distances",
+                               [](const DistanceTableResult& r) {
+                                   return matrix(r.distances, r.sources.size(), r.targets.size());
+                               })
+        .def_readwrite("message", &DistanceTableResult::message)
+        .def_readonly("stats", &DistanceTableResult::stats);
 
     // TourResult
     py::class_<TourResult>(m, "TourResult")
@@ -43,7 +266,8 @@ PYBIND11_MODULE(pathfinder, m) {
         .def_readwrite("found", &TourResult::found)
         .def_readwrite("path", &TourResult::path)
         .def_readwrite("totalDistance", &TourResult::totalDistance)
-        .def_readwrite("message", &TourResult::message);
+        .def_readwrite("message", &TourResult::message)
+        .def_readonly("stats", &TourResult::stats);
 
     // MSTResult
     py::class_<MSTResult>(m, "MSTResult")
@@ -51,41 +275,423 @@ PYBIND11_MODULE(pathfinder, m) {
         .def_readwrite("found", &MSTResult::found)
         .def_readwrite("edges", &MSTResult::edges)
         .def_readwrite("totalCost", &MSTResult::totalCost)
-        .def_readwrite("message", &MSTResult::message);
+        .def_readwrite("message", &MSTResult::message)
+        .def_readonly("stats", &MSTResult::stats);
+
+    // BulkLoadResult
+    py::class_<BulkLoadResult>(m, "BulkLoadResult")
+        .def(py::init<>())
+        .def_readwrite("success", &BulkLoadResult::success)
+        .def_readwrite("rowsRead", &BulkLoadResult::rowsRead)
+        .def_readwrite("rowsAccepted", &BulkLoadResult::rowsAccepted)
+        .def_readwrite("rowsRejected", &BulkLoadResult::rowsRejected)
+        .def_readwrite("duplicates", &BulkLoadResult::duplicates)
+        .def_readwrite("seconds", &BulkLoadResult::seconds)
+        .def_readwrite("rowsPerSecond", &BulkLoadResult::rowsPerSecond)
+        .def_readwrite("message", &BulkLoadResult::message);
+
+    // JournalResult
+    py::class_<JournalResult>(m, "JournalResult")
+        .def(py::init<>())
+        .def_readwrite("success", &JournalResult::success)
+        .def_readwrite("sequence", &JournalResult::sequence)
+        .def_readwrite("applied", &JournalResult::applied)
+        .def_readwrite("skipped", &JournalResult::skipped)
+        .def_readwrite("rejected", &JournalResult::rejected)
+        .def_readwrite("message", &JournalResult::message);
 
     // PathFinder class
     py::class_<PathFinder>(m, "PathFinder")
         .def(py::init<>())
+        .def_property("collect_stats", &PathFinder::collectsStats, &PathFinder::setCollectStats,
+                      "Fill the stats of every query result (off by default)")
         .def("add_city", &PathFinder::addCity,
              "Add a route between two cities",
-             py::arg("city1"), py::arg("city2"), py::arg("distance"))
+             py::arg("city1"), py::arg("city2"), py::arg("distance"), NoGil())
         .def("update_city", &PathFinder::updateCity,
              "Update an existing route between two cities",
-             py::arg("city1"), py::arg("city2"), py::arg("distance"))
+             py::arg("city1"), py::arg("city2"), py::arg("distance"), NoGil())
         .def("remove_city", &PathFinder::removeCity,
              "Remove a route between two cities",
-             py::arg("city1"), py::arg("city2"))
-        .def("find_shortest_path", &PathFinder::findShortestPath,
+             py::arg("city1"), py::arg("city2"), NoGil())
+        .def("add_routes", &PathFinder::addRoutes,
+             "Bulk-add (city1, city2, distance) routes; duplicates resolve to the last row",
+             py::arg("routes"), NoGil())
+        .def("load_routes_file", &PathFinder::loadRoutesFile,
+             "Bulk-load routes from a CSV or TSV file",
+             py::arg("path"), NoGil())
+        .def("update_routes", &PathFinder::updateRoutes,
+             "Set new distances for existing (city1, city2, distance) routes in one pass",
+             py::arg("routes"), NoGil())
+        .def("apply_changes",
+             [](PathFinder& pf, const vector<ChangeRow>& rows) {
+                 vector<RouteChange> changes = changesFrom(rows);
+                 py::gil_scoped_release nogil;
+                 return pf.applyChanges(changes);
+             },
+             "Apply journalled (sequence, 'add'|'update'|'remove', city1, city2, distance) changes "
+             "numbered after journal_sequence(), in order; earlier ones are skipped",
+             py::arg("changes"))
+        .def("journal_sequence", &PathFinder::journalSequence,
+             "Last change sequence applied by apply_changes", NoGil())
+        .def("set_journal_sequence", &PathFinder::setJournalSequence,
+             "Record that the routes hold every change up to sequence, e.g. after a full reload",
+             py::arg("sequence"), NoGil())
+        .def("build_hierarchy", &PathFinder::buildHierarchy,
+             "Build a customizable contraction hierarchy; find_shortest_path uses it "
+             "until a new route or bulk load drops it",
+             NoGil())
+        .def("has_hierarchy", &PathFinder::hasHierarchy,
+             "Whether a contraction hierarchy is serving shortest paths", NoGil())
+        .def("reorder", &PathFinder::reorder,
+             "Renumber cities for cache locality: 'rcm' (reverse Cuthill-McKee), 'bfs' or 'degree'. "
+             "Names are unaffected; city ids change",
+             py::arg("method") = "rcm", NoGil())
+        .def("compress", &PathFinder::compress,
+             "Pack the route lists (gap-encoded targets, bit-packed distances) to save memory; "
+             "queries decode them on the fly and the next mutation unpacks them",
+             NoGil())
+        .def("is_compressed", &PathFinder::isCompressed,
+             "Whether the route lists are packed", NoGil())
+        .def("add_routes_arrays",
+             [](PathFinder& pf, const vector<string>& names, IntColumn source,
+                IntColumn target, IntColumn weight) {
+                 checkColumns(source, target, weight);
+                 py::gil_scoped_release nogil; // the arrays stay referenced by this frame
+                 return pf.addRoutesColumns(names, source.data(), target.data(),
+                                            weight.data(), source.shape(0));
+             },
+             "Bulk-add routes from integer arrays; source and target index into names",
+             py::arg("names"), py::arg("source"), py::arg("target"), py::arg("weight"))
+        .def("export_names",
+             [](const PathFinder& pf) {
+                 vector<uint8_t> bytes;
+                 vector<int64_t> offsets;
+                 {
+                     py::gil_scoped_release nogil;
+                     pf.exportNames(bytes, offsets);
+                 }
+                 return py::make_tuple(adopt(move(bytes)), adopt(move(offsets)));
+             },
+             "City names by id as (utf-8 bytes, offsets); name i is bytes[offsets[i]:offsets[i+1]]")
+        .def("export_routes",
+             [](const PathFinder& pf) {
+                 vector<int32_t> source, target, weight;
+                 {
+                     py::gil_scoped_release nogil;
+                     pf.exportRoutes(source, target, weight);
+                 }
+                 return py::make_tuple(adopt(move(source)), adopt(move(target)), adopt(move(weight)));
+             },
+             "Every route once as (source ids, target ids, weights) int32 arrays")
+        .def("city_ids",
+             [](const PathFinder& pf, const vector<string>& names) {
+                 vector<int32_t> ids;
+                 {
+                     py::gil_scoped_release nogil;
+                     ids = pf.cityIds(names);
+                 }
+                 return adopt(move(ids));
+             },
+             "Ids of the given city names (-1 if unknown)",
+             py::arg("names"))
+        .def("find_shortest_path_ids",
+             [](PathFinder& pf, string start, string end) {
+                 int distance;
+                 vector<int32_t> ids;
+                 {
+                     py::gil_scoped_release nogil;
+                     ShortestPathResult res = pf.findShortestPath(start, end);
+                     distance = res.found ? res.distance : -1;
+                     ids = pf.cityIds(res.path);
+                 }
+                 return py::make_tuple(distance, adopt(move(ids)));
+             },
+             "Shortest path as (distance or -1, int32 array of city ids)",
+             py::arg("start"), py::arg("end"))
+        .def("find_reachable_city_ids",
+             [](PathFinder& pf, string start) {
+                 vector<int32_t> ids;
+                 {
+                     py::gil_scoped_release nogil;
+                     ids = pf.cityIds(pf.findReachableCities(start));
+                 }
+                 return adopt(move(ids));
+             },
+             "Ids of all cities reachable from start as an int32 array",
+             py::arg("start"))
+        .def("find_shortest_path",
+             [](PathFinder& pf, string start, string end) {
+                 return traced("python.find_shortest_path", [&] { return pf.findShortestPath(start, end); });
+             },
              "Find the shortest path between two cities using Dijkstra's algorithm",
              py::arg("start"), py::arg("end"))
-        .def("find_longest_path", &PathFinder::findLongestPath,
+        .def("find_longest_path",
+             [](PathFinder& pf, string start, string end) {
+                 return traced("python.find_longest_path", [&] { return pf.findLongestPath(start, end); });
+             },
              "Find the longest simple path between two cities using DFS",
              py::arg("start"), py::arg("end"))
-        .def("find_fewest_stops", &PathFinder::findFewestStops,
+        .def("find_fewest_stops",
+             [](PathFinder& pf, string start, string end) {
+                 return traced("python.find_fewest_stops", [&] { return pf.findFewestStops(start, end); });
+             },
              "Find path with fewest stops using BFS",
              py::arg("start"), py::arg("end"))
-        .def("find_reachable_cities", &PathFinder::findReachableCities,
+        .def("find_shortest_path_with_max_stops",
+             [](PathFinder& pf, string start, string end, int maxStops) {
+                 return traced("python.find_shortest_path_with_max_stops",
+                               [&] { return pf.findShortestPathWithMaxStops(start, end, maxStops); });
+             },
+             "Find the shortest path that uses at most max_stops routes",
+             py::arg("start"), py::arg("end"), py::arg("max_stops"))
+        .def("find_stops_pareto_front",
+             [](PathFinder& pf, string start, string end, int maxStops) {
+                 return traced("python.find_stops_pareto_front",
+                               [&] { return pf.findStopsParetoFront(start, end, maxStops); });
+             },
+             "Best distance for every number of stops up to max_stops, as a Pareto front",
+             py::arg("start"), py::arg("end"), py::arg("max_stops"))
+        .def("find_k_shortest_paths",
+             [](PathFinder& pf, string start, string end, int k) {
+                 return traced("python.find_k_shortest_paths",
+                               [&] { return pf.findKShortestPaths(start, end, k); });
+             },
+             "Find the k shortest loopless paths, shortest first (Yen)",
+             py::arg("start"), py::arg("end"), py::arg("k"))
+        .def("find_alternative_routes",
+             [](PathFinder& pf, string start, string end, int maxRoutes, double maxStretch,
+                double maxOverlap, double minLocalOptimality) {
+                 return traced("python.find_alternative_routes", [&] {
+                     return pf.findAlternativeRoutes(start, end, maxRoutes, maxStretch, maxOverlap,
+                                                     minLocalOptimality);
+                 });
+             },
+             "Shortest path plus meaningfully different alternatives (plateau method): at most "
+             "max_stretch times as long, sharing at most max_overlap of the shortest distance, "
+             "locally optimal over min_local_optimality of it",
+             py::arg("start"), py::arg("end"), py::arg("max_routes") = 3, py::arg("max_stretch") = 1.25,
+             py::arg("max_overlap") = 0.8, py::arg("min_local_optimality") = 0.25)
+        .def("find_reachable_cities",
+             [](PathFinder& pf, string start) {
+                 return traced("python.find_reachable_cities", [&] { return pf.findReachableCities(start); });
+             },
              "Find all reachable cities from start",
              py::arg("start"))
-        .def("plan_multi_city_tour", &PathFinder::planMultiCityTour,
+        .def("connected_components",
+             [](PathFinder& pf) {
+                 return traced("python.connected_components", [&] { return pf.connectedComponents(); });
+             },
+             "Component of every city id (-1 for ids without routes) and component sizes, largest first")
+        .def("cities_within",
+             [](PathFinder& pf, string start, int maxDistance) {
+                 return traced("python.cities_within", [&] { return pf.citiesWithin(start, maxDistance); });
+             },
+             "Cities at most max_distance away, nearest first",
+             py::arg("start"), py::arg("max_distance"))
+        .def("cities_within_stops",
+             [](PathFinder& pf, string start, int maxStops) {
+                 return traced("python.cities_within_stops", [&] { return pf.citiesWithinStops(start, maxStops); });
+             },
+             "Cities at most max_stops stops away, fewest stops first",
+             py::arg("start"), py::arg("max_stops"))
+        .def("isochrone_bands",
+             [](PathFinder& pf, string start, vector<int> radii, bool parallel) {
+                 return traced("python.isochrone_bands", [&] { return pf.isochroneBands(start, radii, parallel); });
+             },
+             "Cities grouped into distance bands (radii ascending) from one bounded search, "
+             "run in parallel if asked",
+             py::arg("start"), py::arg("radii"), py::arg("parallel") = false)
+        .def("nearest_cities",
+             [](PathFinder& pf, string start, int k, vector<string> candidates, py::object filter) {
+                 if (filter.is_none()) {
+                     return traced("python.nearest_cities",
+                                   [&] { return pf.nearestCities(start, k, candidates); });
+                 }
+                 // The filter runs here, under the GIL and outside the engine's
+                 // lock: taking the GIL inside it could deadlock against a
+                 // thread that holds the GIL and waits to mutate the engine.
+                 // The search runs unfiltered for k, 2k, 4k... cities, each a
+                 // prefix of the next, until k pass or none are left to reach.
+                 TraceSpan request("python.nearest_cities", "python");
+                 CitiesWithinResult res;
+                 vector<CityDistance> accepted;
+                 size_t checked = 0;
+                 for (int want = k;; want = want > INT_MAX / 2 ? INT_MAX : want * 2) {
+                     {
+                         py::gil_scoped_release nogil;
+                         res = pf.nearestCities(start, want, candidates);
+                     }
+                     if (!res.found) return py::cast(move(res));
+                     for (; checked < res.cities.size() && (int)accepted.size() < k; ++checked) {
+                         if (filter(res.cities[checked].city).cast<bool>()) accepted.push_back(res.cities[checked]);
+                     }
+                     if ((int)accepted.size() == k || (int)res.cities.size() < want || want == INT_MAX) break;
+                 }
+                 res.cities = move(accepted);
+                 res.message = (int)res.cities.size() == k
+                     ? "Found the " + to_string(k) + " nearest cities."
+                     : "Only " + to_string(res.cities.size()) + " matching cities are reachable.";
+                 TraceSpan convert("pybind11.convert", "python");
+                 return py::cast(move(res));
+             },
+             "The k cities nearest to start, optionally only among candidates and those for which "
+             "filter(city) is true; with a filter, stats are those of the last search",
+             py::arg("start"), py::arg("k"), py::arg("candidates") = vector<string>(),
+             py::arg("filter") = py::none())
+        .def("distance_matrix",
+             [](PathFinder& pf, vector<string> cities, bool withNextHop) {
+                 return traced("python.distance_matrix", [&] { return pf.distanceMatrix(cities, withNextHop); });
+             },
+             "All-pairs distances over the routes among cities (every city when empty), "
+             "with next hops for paths if asked",
+             py::arg("cities") = vector<string>(), py::arg("with_next_hop") = false)
+        .def("distances_from",
+             [](PathFinder& pf, string start) {
+                 return traced("python.distances_from", [&] { return pf.distancesFrom(start); });
+             },
+             "Every city reachable from start, nearest first, by a parallel search",
+             py::arg("start"))
+        .def("distance_table",
+             [](PathFinder& pf, vector<string> sources, vector<string> targets) {
+                 return traced("python.distance_table", [&] { return pf.distanceTable(sources, targets); });
+             },
+             "Distances from each source to each target, one parallel search per source",
+             py::arg("sources"), py::arg("targets"))
+        .def("plan_multi_city_tour",
+             [](PathFinder& pf, vector<string> cities) {
+                 return traced("python.plan_multi_city_tour", [&] { return pf.planMultiCityTour(cities); });
+             },
              "Plan a multi-city tour",
              py::arg("cities"))
-        .def("find_cheapest_network", &PathFinder::findCheapestNetwork,
+        .def("find_cheapest_network",
+             [](PathFinder& pf) {
+                 return traced("python.find_cheapest_network", [&] { return pf.findCheapestNetwork(); });
+             },
              "Find the cheapest network (MST)")
-        .def("get_all_cities", &PathFinder::getAllCities,
+        .def("get_all_cities",
+             [](PathFinder& pf) {
+                 return traced("python.get_all_cities", [&] { return pf.getAllCities(); });
+             },
              "Get all cities in the graph")
-        .def("get_all_routes", &PathFinder::getAllRoutes,
+        .def("get_all_routes",
+             [](PathFinder& pf) {
+                 return traced("python.get_all_routes", [&] { return pf.getAllRoutes(); });
+             },
              "Get all routes in the graph")
         .def("clear_all", &PathFinder::clearAll,
-             "Clear all data");
+             "Clear all data", NoGil())
+        .def("save", &PathFinder::save,
+             "Write the network and its journal sequence to a binary snapshot file",
+             py::arg("path"), NoGil())
+        .def("load", &PathFinder::load,
+             "Replace the network with a memory-mapped snapshot file and restore its journal sequence; "
+             "verify=True also checks its full checksum",
+             py::arg("path"), py::arg("verify") = false, NoGil())
+
+        // Async variants run on the engine's thread pool. They return an
+        // asyncio future when called from a coroutine (await it), otherwise
+        // a concurrent.futures.Future.
+        .def("find_shortest_path_async",
+             [](py::object self, string start, string end) {
+                 return submitQuery(self, [start, end](PathFinder& pf) { return pf.findShortestPath(start, end); });
+             },
+             "Shortest path on the engine thread pool; returns an awaitable future",
+             py::arg("start"), py::arg("end"))
+        .def("find_longest_path_async",
+             [](py::object self, string start, string end) {
+                 return submitQuery(self, [start, end](PathFinder& pf) { return pf.findLongestPath(start, end); });
+             },
+             "Longest path on the engine thread pool; returns an awaitable future",
+             py::arg("start"), py::arg("end"))
+        .def("find_fewest_stops_async",
+             [](py::object self, string start, string end) {
+                 return submitQuery(self, [start, end](PathFinder& pf) { return pf.findFewestStops(start, end); });
+             },
+             "Fewest stops on the engine thread pool; returns an awaitable future",
+             py::arg("start"), py::arg("end"))
+        .def("find_reachable_cities_async",
+             [](py::object self, string start) {
+                 return submitQuery(self, [start](PathFinder& pf) { return pf.findReachableCities(start); });
+             },
+             "Reachable cities on the engine thread pool; returns an awaitable future",
+             py::arg("start"))
+        .def("plan_multi_city_tour_async",
+             [](py::object self, vector<string> cities) {
+                 return submitQuery(self, [cities](PathFinder& pf) { return pf.planMultiCityTour(cities); });
+             },
+             "Multi-city tour on the engine thread pool; returns an awaitable future",
+             py::arg("cities"))
+        .def("find_cheapest_network_async",
+             [](py::object self) {
+                 return submitQuery(self, [](PathFinder& pf) { return pf.findCheapestNetwork(); });
+             },
+             "Cheapest network on the engine thread pool; returns an awaitable future");
+
+    // One engine per process, shared with TravelPlannerLib
+    m.def("shared_engine",
+          []() { return &PathFinder::shared(); },
+          "The process-wide PathFinder that TravelPlannerLib also uses",
+          py::return_value_policy::reference);
+    bindTravelPlanner(m);
+
+    // Engine-wide metrics (every PathFinder call in this process)
+    m.def("metrics_text",
+          []() { return Metrics::global().prometheusText(); },
+          "Call counts, errors and latency histograms in Prometheus text format", NoGil());
+    m.def("metrics_snapshot",
+          [](bool reset) {
+              vector<OperationSnapshot> ops;
+              {
+                  py::gil_scoped_release nogil;
+                  ops = Metrics::global().snapshot(reset);
+              }
+              py::list result;
+              for (const auto& op : ops) {
+                  py::dict errors;
+                  for (int k = 1; k < METRIC_OUTCOMES; ++k) {
+                      errors[Metrics::outcomeName((MetricOutcome)k)] = op.outcomes[k];
+                  }
+                  py::dict entry;
+                  entry["operation"] = op.operation;
+                  entry["calls"] = op.calls;
+                  entry["errors"] = errors;
+                  entry["total_seconds"] = op.totalNanos / 1e9;
+                  entry["max_seconds"] = op.maxNanos / 1e9;
+                  entry["p50_seconds"] = op.quantileSeconds(0.50);
+                  entry["p90_seconds"] = op.quantileSeconds(0.90);
+                  entry["p99_seconds"] = op.quantileSeconds(0.99);
+                  result.append(entry);
+              }
+              return result;
+          },
+          "Per-operation totals and latency quantiles; reset=True also zeroes them",
+          py::arg("reset") = false);
+    m.def("metrics_reset",
+          []() { Metrics::global().reset(); },
+          "Zero all engine metrics", NoGil());
+
+    // Request tracing in the Chrome trace event format
+    m.def("trace_start",
+          [](double sampleRate, size_t capacity) { Tracer::global().start(sampleRate, capacity); },
+          "Start recording trace spans for the given fraction of requests, keeping at most capacity events",
+          py::arg("sample_rate") = 1.0, py::arg("capacity") = 100000);
+    m.def("trace_stop",
+          []() { Tracer::global().stop(); },
+          "Stop recording; collected events are kept until trace_clear()");
+    m.def("trace_json",
+          []() { return Tracer::global().json(); },
+          "Collected events as Chrome trace JSON (chrome://tracing, ui.perfetto.dev)", NoGil());
+    m.def("trace_dump",
+          [](const string& path) {
+              OperationResult res;
+              res.success = Tracer::global().writeJson(path, res.message);
+              if (res.success) res.message = "Trace written to '" + path + "'.";
+              return res;
+          },
+          "Write the collected events as Chrome trace JSON to path",
+          py::arg("path"), NoGil());
+    m.def("trace_clear",
+          []() { Tracer::global().clear(); },
+          "Drop all collected trace events", NoGil());
 }
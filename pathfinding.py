@@ -0,0 +1,10 @@
+"""Chatbot API of the C++ pathfinding engine.
+
+TravelPlannerLib and its result types are compiled into the pathfinder
+extension, so the chatbot and the pathfinder module share one engine,
+one set of metrics and one tracer. Build it with
+``python setup.py build_ext --inplace``.
+"""
+from pathfinder import MapStats, PathResult, RouteOperationResult, TravelPlannerLib
+
+__all__ = ['MapStats', 'PathResult', 'RouteOperationResult', 'TravelPlannerLib']
@@ -1,12 +1,14 @@
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
+#include <pybind11/numpy.h>
 #include "travel_planner_lib.h"
+#include "wrapper_util.h"
 
-namespace py = pybind11;
-
-PYBIND11_MODULE(pathfinding, m) {
-    m.doc() = "Travel Planner C++ Pathfinding Engine";
-
+// The chatbot's TravelPlannerLib and its result types. Registered on the
+// pathfinder module (pathfinder_wrapper.cpp), so the facade drives that
+// module's PathFinder::shared(), metrics and tracer rather than a second
+// copy of the engine; pathfinding.py re-exports them for the chatbot.
+void bindTravelPlanner(py::module_& m) {
     // PathResult structure
     py::class_<PathResult>(m, "PathResult")
         .def(py::init<>())
@@ -32,25 +34,74 @@ PYBIND11_MODULE(pathfinding, m) {
         .def(py::init<>())
         .def("add_route", &TravelPlannerLib::addRoute,
              "Add a route between two cities",
-             py::arg("source"), py::arg("destination"), py::arg("distance"))
+             py::arg("source"), py::arg("destination"), py::arg("distance"), NoGil())
         .def("delete_route", &TravelPlannerLib::deleteRoute,
              "Delete a route between two cities",
-             py::arg("source"), py::arg("destination"))
+             py::arg("source"), py::arg("destination"), NoGil())
         .def("find_shortest_path", &TravelPlannerLib::findShortestPath,
              "Find the shortest path between two cities using Dijkstra's algorithm",
-             py::arg("start"), py::arg("end"))
+             py::arg("start"), py::arg("end"), NoGil())
         .def("find_fewest_stops", &TravelPlannerLib::findFewestStops,
              "Find the path with fewest stops between two cities using BFS",
-             py::arg("start"), py::arg("end"))
+             py::arg("start"), py::arg("end"), NoGil())
         .def("get_reachable_cities", &TravelPlannerLib::getReachableCities,
              "Get all cities reachable from a starting city",
-             py::arg("start"))
+             py::arg("start"), NoGil())
         .def("get_map_stats", &TravelPlannerLib::getMapStats,
-             "Get statistics about the map")
+             "Get statistics about the map", NoGil())
         .def("get_all_cities", &TravelPlannerLib::getAllCities,
-             "Get all cities in the map")
+             "Get all cities in the map", NoGil())
         .def("get_all_routes", &TravelPlannerLib::getAllRoutes,
-             "Get all routes in the map")
+             "Get all routes in the map", NoGil())
+        .def("add_routes", &TravelPlannerLib::addRoutes,
+             "Add many (source, destination, distance) routes at once",
+             py::arg("routes"), NoGil())
+        .def("add_routes_arrays",
+             [](TravelPlannerLib& lib, const vector<string>& names, IntColumn source,
+                IntColumn target, IntColumn weight) {
+                 checkColumns(source, target, weight);
+                 py::gil_scoped_release nogil; // the arrays stay referenced by this frame
+                 return lib.addRoutesColumns(names, source.data(), target.data(),
+                                             weight.data(), source.shape(0));
+             },
+             "Add routes from integer arrays; source and target index into names",
+             py::arg("names"), py::arg("source"), py::arg("target"), py::arg("weight"))
+        .def("export_names",
+             [](TravelPlannerLib& lib) {
+                 vector<uint8_t> bytes;
+                 vector<int64_t> offsets;
+                 {
+                     py::gil_scoped_release nogil;
+                     lib.exportNames(bytes, offsets);
+                 }
+                 return py::make_tuple(adopt(move(bytes)), adopt(move(offsets)));
+             },
+             "City names by id as (utf-8 bytes, offsets); name i is bytes[offsets[i]:offsets[i+1]]")
+        .def("export_routes",
+             [](TravelPlannerLib& lib) {
+                 vector<int32_t> source, target, weight;
+                 {
+                     py::gil_scoped_release nogil;
+                     lib.exportRoutes(source, target, weight);
+                 }
+                 return py::make_tuple(adopt(move(source)), adopt(move(target)), adopt(move(weight)));
+             },
+             "Every route once as (source ids, target ids, weights) int32 arrays")
+        .def("apply_changes", &TravelPlannerLib::applyChanges,
+             "Apply journalled (sequence, 'add'|'update'|'remove', source, destination, distance) "
+             "changes numbered after journal_sequence(), in order",
+             py::arg("changes"), NoGil())
+        .def("journal_sequence", &TravelPlannerLib::journalSequence,
+             "Last change sequence applied by apply_changes", NoGil())
+        .def("set_journal_sequence", &TravelPlannerLib::setJournalSequence,
+             "Record that the routes hold every change up to sequence, e.g. after a full reload",
+             py::arg("sequence"), NoGil())
+        .def("save_snapshot", &TravelPlannerLib::saveSnapshot,
+             "Write the map and its journal sequence to a binary snapshot file",
+             py::arg("path"), NoGil())
+        .def("load_snapshot", &TravelPlannerLib::loadSnapshot,
+             "Replace the map with a memory-mapped snapshot file and restore its journal sequence",
+             py::arg("path"), NoGil())
         .def("clear", &TravelPlannerLib::clear,
-             "Clear all data from the map");
+             "Clear all data from the map", NoGil());
 }
@@ -17,14 +17,49 @@ class get_pybind_include(object):
         return pybind11.get_include()
 
 
+# The engine is built once, into the pathfinder module, together with the
+# chatbot's TravelPlannerLib bindings; pathfinding.py re-exports those
+# (setup_new.py builds the same module)
+engine_sources = [
+    'cpp_src/src/NameFold.cpp',
+    'cpp_src/src/Graph.cpp',
+    'cpp_src/src/GraphSnapshot.cpp',
+    'cpp_src/src/GraphOrder.cpp',
+    'cpp_src/src/CompressedAdjacency.cpp',
+    'cpp_src/src/QueryWorkspace.cpp',
+    'cpp_src/src/ShortestPath.cpp',
+    'cpp_src/src/ShortestPathTree.cpp',
+    'cpp_src/src/CustomizableHierarchy.cpp',
+    'cpp_src/src/LongestPath.cpp',
+    'cpp_src/src/FewestStops.cpp',
+    'cpp_src/src/MaxStopsPath.cpp',
+    'cpp_src/src/KShortestPaths.cpp',
+    'cpp_src/src/AlternativeRoutes.cpp',
+    'cpp_src/src/AllPairs.cpp',
+    'cpp_src/src/DeltaStepping.cpp',
+    'cpp_src/src/ReachableCities.cpp',
+    'cpp_src/src/ConnectedComponents.cpp',
+    'cpp_src/src/CitiesWithin.cpp',
+    'cpp_src/src/NearestCities.cpp',
+    'cpp_src/src/MultiCityTour.cpp',
+    'cpp_src/src/CheapestNetwork.cpp',
+    'cpp_src/src/RouteLoader.cpp',
+    'cpp_src/src/RouteJournal.cpp',
+    'cpp_src/src/ThreadPool.cpp',
+    'cpp_src/src/Tracer.cpp',
+    'cpp_src/src/Metrics.cpp',
+    'cpp_src/src/PathFinder.cpp',
+]
+
 ext_modules = [
     Extension(
-        'pathfinding',
-        ['pathfinding_wrapper.cpp'],
+        'pathfinder',
+        ['pathfinder_wrapper.cpp', 'pathfinding_wrapper.cpp'] + engine_sources,
         include_dirs=[
             # Path to pybind11 headers
             get_pybind_include(),
             '.',
+            'cpp_src/include',
         ],
         language='c++',
         extra_compile_args=['-std=c++17'],
@@ -103,6 +138,7 @@ setup(
     description='C++ Pathfinding Engine for Travel Planner',
     long_description='',
     ext_modules=ext_modules,
+    py_modules=['pathfinding'],
     setup_requires=['pybind11>=2.6.0'],
     cmdclass={'build_ext': BuildExt},
     zip_safe=False,
@@ -6,13 +6,34 @@ import sys
 # Define the C++ source files
 cpp_sources = [
     'pathfinder_wrapper.cpp',
+    'pathfinding_wrapper.cpp',
+    'cpp_src/src/NameFold.cpp',
     'cpp_src/src/Graph.cpp',
+    'cpp_src/src/GraphSnapshot.cpp',
+    'cpp_src/src/GraphOrder.cpp',
+    'cpp_src/src/CompressedAdjacency.cpp',
+    'cpp_src/src/QueryWorkspace.cpp',
     'cpp_src/src/ShortestPath.cpp',
+    'cpp_src/src/ShortestPathTree.cpp',
+    'cpp_src/src/CustomizableHierarchy.cpp',
     'cpp_src/src/LongestPath.cpp',
     'cpp_src/src/FewestStops.cpp',
+    'cpp_src/src/MaxStopsPath.cpp',
+    'cpp_src/src/KShortestPaths.cpp',
+    'cpp_src/src/AlternativeRoutes.cpp',
+    'cpp_src/src/AllPairs.cpp',
+    'cpp_src/src/DeltaStepping.cpp',
     'cpp_src/src/ReachableCities.cpp',
+    'cpp_src/src/ConnectedComponents.cpp',
+    'cpp_src/src/CitiesWithin.cpp',
+    'cpp_src/src/NearestCities.cpp',
     'cpp_src/src/MultiCityTour.cpp',
     'cpp_src/src/CheapestNetwork.cpp',
+    'cpp_src/src/RouteLoader.cpp',
+    'cpp_src/src/RouteJournal.cpp',
+    'cpp_src/src/ThreadPool.cpp',
+    'cpp_src/src/Tracer.cpp',
+    'cpp_src/src/Metrics.cpp',
     'cpp_src/src/PathFinder.cpp',
 ]
 
@@ -36,6 +57,7 @@ setup(
     author='Path Finder Team',
     description='Modular Path Finding Engine',
     ext_modules=ext_modules,
+    py_modules=['pathfinding'],
     cmdclass={'build_ext': build_ext},
     zip_safe=False,
     python_requires='>=3.7',
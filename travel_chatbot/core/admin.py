@@ -3,5 +3,6 @@ from .models import *
 
 admin.site.register(Route)
 admin.site.register(City)
+admin.site.register(RouteChange)
 
 # Register your models here.
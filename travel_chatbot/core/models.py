@@ -36,6 +36,29 @@ class Route(models.Model):
         super().save(*args, **kwargs)
 
 
+class RouteChange(models.Model):
+    """One recorded route mutation, written by core.signals. The id is the
+    sequence number the pathfinding engine replays from, so every worker
+    applies only what it has not seen (PathfindingService.sync_with_database).
+    City names are copied so a change outlives the cities it mentions."""
+    ADD = 'add'
+    UPDATE = 'update'
+    REMOVE = 'remove'
+    KIND_CHOICES = [(ADD, 'Add'), (UPDATE, 'Update'), (REMOVE, 'Remove')]
+
+    kind = models.CharField(max_length=10, choices=KIND_CHOICES)
+    source = models.CharField(max_length=100)
+    destination = models.CharField(max_length=100)
+    distance = models.IntegerField(default=0, help_text="Distance in kilometers, 0 for a removal")
+    created_at = models.DateTimeField(auto_now_add=True)
+
+    class Meta:
+        ordering = ['id']
+
+    def __str__(self):
+        return f"#{self.id} {self.kind} {self.source} <-> {self.destination} ({self.distance}km)"
+
+
 class ChatSession(models.Model):
     """Represents a chat conversation session"""
     session_id = models.UUIDField(default=uuid.uuid4, unique=True, editable=False)
@@ -0,0 +1,72 @@
+from django.db.models import Q
+from django.db.models.signals import post_delete, post_save, pre_save
+from django.dispatch import receiver
+
+from .models import City, Route, RouteChange
+
+
+# Route rows and City renames written through the ORM are journalled for
+# the pathfinding engine. QuerySet.update() and raw SQL bypass these signals; follow them
+# with a full reload (PathfindingService.sync_with_database(full=True)).
+
+@receiver(pre_save, sender=Route)
+def remember_route_cities(sender, instance, **kwargs):
+    """Keep the stored endpoints so a route moved to other cities is
+    journalled as a removal of the old pair"""
+    instance._stored_cities = None
+    if instance.pk:
+        stored = Route.objects.filter(pk=instance.pk).values_list(
+            'source__name', 'destination__name').first()
+        instance._stored_cities = stored
+
+
+@receiver(post_save, sender=Route)
+def record_route_saved(sender, instance, created, **kwargs):
+    source, destination = instance.source.name, instance.destination.name
+    stored = getattr(instance, '_stored_cities', None)
+    if stored and stored != (source, destination):
+        RouteChange.objects.create(kind=RouteChange.REMOVE, source=stored[0], destination=stored[1])
+    RouteChange.objects.create(
+        kind=RouteChange.ADD if created else RouteChange.UPDATE,
+        source=source,
+        destination=destination,
+        distance=instance.distance,
+    )
+
+
+@receiver(post_delete, sender=Route)
+def record_route_deleted(sender, instance, **kwargs):
+    RouteChange.objects.create(
+        kind=RouteChange.REMOVE,
+        source=instance.source.name,
+        destination=instance.destination.name,
+    )
+
+
+@receiver(pre_save, sender=City)
+def remember_city_name(sender, instance, **kwargs):
+    """Keep the stored name so a rename can be journalled for its routes"""
+    instance._stored_name = None
+    if instance.pk:
+        instance._stored_name = City.objects.filter(pk=instance.pk).values_list(
+            'name', flat=True).first()
+
+
+@receiver(post_save, sender=City)
+def record_city_renamed(sender, instance, created, **kwargs):
+    """A rename moves every route of the city: journal each as a removal
+    under the old name and an addition under the new one"""
+    old_name = getattr(instance, '_stored_name', None)
+    if created or not old_name or old_name == instance.name:
+        return
+    routes = Route.objects.filter(Q(source=instance) | Q(destination=instance)).select_related(
+        'source', 'destination')
+    for route in routes:
+        other = route.destination.name if route.source_id == instance.pk else route.source.name
+        RouteChange.objects.create(kind=RouteChange.REMOVE, source=old_name, destination=other)
+        RouteChange.objects.create(
+            kind=RouteChange.ADD,
+            source=instance.name,
+            destination=other,
+            distance=route.distance,
+        )
@@ -1,5 +1,6 @@
 import sys
 import os
+import time
 from typing import Dict, Any, List, Tuple
 from django.conf import settings
 
@@ -19,32 +20,139 @@ class PathfindingService:
     Provides a Python interface to the C++ algorithms.
     """
     
+    # Journal ids are handed out when a row is inserted, not when its
+    # transaction commits, so a missing id below the last one applied may
+    # still show up. Missing ids are rechecked on every sync for this long,
+    # after which they are taken to be rolled back.
+    GAP_GRACE_SECONDS = 60
+    # At most this many ids below the newest one are tracked as missing
+    GAP_WINDOW = 1000
+
     def __init__(self):
         if CPP_AVAILABLE:
             self.engine = pathfinding.TravelPlannerLib()
         else:
             self.engine = None
-    
-    def sync_with_database(self):
-        """Load routes from Django database into C++ engine"""
+        self.loaded = False  # set by the first full sync_with_database
+        self.sequence = 0    # journal sequence this service left the engine at
+        self.gaps = {}       # missing journal id -> time.monotonic() it was noticed
+
+    def invalidate(self):
+        """Reload every route on the next sync, e.g. after the shared engine
+        was cleared or given other routes outside this service"""
+        self.loaded = False
+
+    def sync_with_database(self, full: bool = False):
+        """Bring the C++ engine up to date with the database.
+
+        The first call (or full=True) loads every route; later calls apply
+        only the RouteChange rows recorded since the last sync, so an edit
+        costs one small batch instead of a reload. The engine is shared with
+        the pathfinder UI, so a journal sequence other than the one this
+        service left behind (clear_all, load_sample, a snapshot load) means
+        the routes were replaced and forces a full reload, as does a journal
+        row that commits late under an id already passed over.
+        """
         if not CPP_AVAILABLE or not self.engine:
             return False
         
-        from core.models import Route
+        from core.models import RouteChange
         
-        # Clear existing data
-        self.engine.clear()
+        if not full and self.loaded:
+            full = self.engine.journal_sequence() != self.sequence or self._gap_filled()
+        if full or not self.loaded:
+            self._reload()
+            return True
         
-        # Load all routes from database
-        routes = Route.objects.select_related('source', 'destination').all()
-        for route in routes:
-            self.engine.add_route(
-                route.source.name,
-                route.destination.name,
-                route.distance
-            )
+        changes = list(
+            RouteChange.objects.filter(id__gt=self.sequence)
+            .order_by('id')
+            .values_list('id', 'kind', 'source', 'destination', 'distance')
+        )
+        if changes:
+            self.engine.apply_changes(changes)
+            self._note_gaps([change[0] for change in changes], self.sequence, changes[-1][0])
+            self.sequence = self.engine.journal_sequence()
+        return True
+
+    def _reload(self):
+        """Replace the engine's routes with the database's: from the mapped
+        snapshot plus the journal after it when settings.PATHFINDER_SNAPSHOT
+        holds a usable one, otherwise in one bulk load of every route"""
+        from core.models import Route, RouteChange
+        
+        # Journal position first: changes committed while the routes
+        # are read get replayed by the next sync, which is harmless
+        latest = RouteChange.objects.order_by('-id').values_list('id', flat=True).first() or 0
+        recent = list(
+            RouteChange.objects.filter(id__gt=latest - self.GAP_WINDOW, id__lte=latest)
+            .values_list('id', flat=True)
+        )
+        
+        if not self._load_snapshot(latest):
+            self.engine.clear()
+            self.engine.add_routes(list(
+                Route.objects.values_list('source__name', 'destination__name', 'distance')
+            ))
+            self.engine.set_journal_sequence(latest)
+            self.save_snapshot()
+        
+        self.sequence = latest
+        self.gaps = {}
+        self._note_gaps(recent, 0, latest)
+        self.loaded = True
+
+    def _load_snapshot(self, latest: int) -> bool:
+        """Map settings.PATHFINDER_SNAPSHOT and replay the journal rows after
+        the sequence it was saved at. A snapshot saved without a journal
+        position, or ahead of this database's journal, is not used."""
+        from core.models import RouteChange
         
+        path = getattr(settings, 'PATHFINDER_SNAPSHOT', '')
+        if not path or not os.path.exists(path):
+            return False
+        if not self.engine.load_snapshot(path).success:
+            return False
+        saved = self.engine.journal_sequence()
+        if saved <= 0 or saved > latest:
+            return False
+        
+        changes = list(
+            RouteChange.objects.filter(id__gt=saved, id__lte=latest)
+            .order_by('id')
+            .values_list('id', 'kind', 'source', 'destination', 'distance')
+        )
+        if changes:
+            self.engine.apply_changes(changes)
+        self.engine.set_journal_sequence(latest)
         return True
+
+    def save_snapshot(self) -> bool:
+        """Write the engine and its journal position to
+        settings.PATHFINDER_SNAPSHOT, so the next process maps it instead
+        of reading every route"""
+        path = getattr(settings, 'PATHFINDER_SNAPSHOT', '')
+        if not path or not CPP_AVAILABLE or not self.engine:
+            return False
+        return self.engine.save_snapshot(path).success
+
+    def _note_gaps(self, ids, after: int, upto: int):
+        """Remember the ids in (after, upto] missing from ids"""
+        seen = set(ids)
+        now = time.monotonic()
+        for missing in range(max(after, upto - self.GAP_WINDOW) + 1, upto + 1):
+            if missing not in seen:
+                self.gaps.setdefault(missing, now)
+
+    def _gap_filled(self) -> bool:
+        """True if a missing journal id has committed since it was noticed"""
+        if not self.gaps:
+            return False
+        from core.models import RouteChange
+        
+        cutoff = time.monotonic() - self.GAP_GRACE_SECONDS
+        self.gaps = {missing: noticed for missing, noticed in self.gaps.items() if noticed >= cutoff}
+        return bool(self.gaps) and RouteChange.objects.filter(id__in=list(self.gaps)).exists()
     
     def add_route(self, source: str, destination: str, distance: int) -> Dict[str, Any]:
         """Add a route to the pathfinding engine"""
@@ -1,3 +1,141 @@
-from django.test import TestCase
+import os
+import tempfile
+from unittest import mock, skipUnless
 
-# Create your tests here.
+from django.test import SimpleTestCase, TestCase, override_settings
+
+from core.models import City, Route, RouteChange
+from .service import CPP_AVAILABLE, PathfindingService
+
+
+@skipUnless(CPP_AVAILABLE, 'C++ pathfinding module not built')
+@override_settings(PATHFINDER_SNAPSHOT='')
+class JournalSyncTests(TestCase):
+    """The engine replays RouteChange rows and reloads when it must"""
+
+    def setUp(self):
+        self.service = PathfindingService()
+        self.cities = {name: City.objects.create(name=name)
+                       for name in ('Berlin', 'Munich', 'Paris', 'Vienna')}
+        self.add('Berlin', 'Paris', 1050)
+        self.add('Munich', 'Vienna', 435)
+        self.service.sync_with_database()
+
+    def add(self, source, destination, distance):
+        return Route.objects.create(source=self.cities[source],
+                                    destination=self.cities[destination],
+                                    distance=distance)
+
+    def engine_routes(self):
+        return {(frozenset((a, b)), d) for a, b, d in self.service.get_all_routes()}
+
+    def database_routes(self):
+        return {(frozenset((r.source.name, r.destination.name)), r.distance)
+                for r in Route.objects.select_related('source', 'destination')}
+
+    def sync(self):
+        """Sync and return how many full reloads it took"""
+        with mock.patch.object(PathfindingService, '_reload', autospec=True,
+                               side_effect=PathfindingService._reload) as reload:
+            self.service.sync_with_database()
+        return reload.call_count
+
+    def test_incremental_sync_applies_add_update_delete(self):
+        self.add('Berlin', 'Munich', 585)
+        route = Route.objects.get(source=self.cities['Munich'], destination=self.cities['Vienna'])
+        route.distance = 400
+        route.save()
+        Route.objects.get(source=self.cities['Berlin'], destination=self.cities['Paris']).delete()
+
+        self.assertEqual(self.sync(), 0)
+        self.assertEqual(self.engine_routes(), self.database_routes())
+        self.assertEqual(self.service.engine.journal_sequence(),
+                         RouteChange.objects.order_by('-id').first().id)
+
+    def test_sync_after_clear_reloads(self):
+        self.add('Berlin', 'Munich', 585)
+        self.service.sync_with_database()
+        self.service.engine.clear()  # as the pathfinder UI's clear_all does
+
+        self.add('Paris', 'Vienna', 1235)
+        self.assertEqual(self.sync(), 1)
+        self.assertEqual(self.engine_routes(), self.database_routes())
+
+    def test_city_rename_moves_its_routes(self):
+        berlin = self.cities['Berlin']
+        berlin.name = 'Potsdam'
+        berlin.save()
+
+        self.assertEqual(self.sync(), 0)
+        self.assertEqual(self.engine_routes(), self.database_routes())
+        self.assertNotIn('Berlin', self.service.get_all_cities())
+
+    def test_late_journal_row_reloads(self):
+        latest = RouteChange.objects.order_by('-id').first().id
+        # Rows committed out of id order: latest + 2 first, latest + 1 later
+        RouteChange.objects.create(id=latest + 2, kind=RouteChange.ADD,
+                                   source='Berlin', destination='Vienna', distance=680)
+        Route.objects.bulk_create([Route(source=self.cities['Berlin'],
+                                         destination=self.cities['Vienna'], distance=680)])
+        self.assertEqual(self.sync(), 0)
+
+        Route.objects.filter(source=self.cities['Munich']).update(distance=400)
+        RouteChange.objects.create(id=latest + 1, kind=RouteChange.UPDATE,
+                                   source='Munich', destination='Vienna', distance=400)
+        self.assertEqual(self.sync(), 1)
+        self.assertEqual(self.engine_routes(), self.database_routes())
+
+    def test_reload_maps_snapshot_and_replays_later_changes(self):
+        with tempfile.TemporaryDirectory() as folder, \
+                override_settings(PATHFINDER_SNAPSHOT=os.path.join(folder, 'routes.snapshot')):
+            self.assertTrue(self.service.save_snapshot())
+            self.add('Berlin', 'Munich', 585)
+            # Not journalled, so only a reload from the database would see it
+            Route.objects.filter(source=self.cities['Munich']).update(distance=1)
+
+            service = PathfindingService()
+            service.sync_with_database()
+
+        routes = {(frozenset((a, b)), d) for a, b, d in service.get_all_routes()}
+        self.assertIn((frozenset(('Berlin', 'Munich')), 585), routes)
+        self.assertIn((frozenset(('Munich', 'Vienna')), 435), routes)
+        self.assertEqual(service.engine.journal_sequence(),
+                         RouteChange.objects.order_by('-id').first().id)
+
+
+@skipUnless(CPP_AVAILABLE, 'C++ pathfinding module not built')
+class NearestCitiesFilterTests(SimpleTestCase):
+    """A Python filter drives the search instead of scanning every city"""
+
+    SIDE = 300
+
+    @classmethod
+    def setUpClass(cls):
+        super().setUpClass()
+        import pathfinder
+        cls.engine = pathfinder.PathFinder()
+        routes = []
+        for y in range(cls.SIDE):
+            for x in range(cls.SIDE):
+                if x + 1 < cls.SIDE:
+                    routes.append((f'g{y}_{x}', f'g{y}_{x + 1}', 1 + (x * 7 + y) % 9))
+                if y + 1 < cls.SIDE:
+                    routes.append((f'g{y}_{x}', f'g{y + 1}_{x}', 1 + (x + y * 5) % 9))
+        cls.engine.add_routes(routes)
+        cls.engine.collect_stats = True
+
+    def test_filtered_query_explores_a_local_ball(self):
+        tested = []
+
+        def even_column(city):
+            tested.append(city)
+            return int(city.split('_')[1]) % 2 == 0
+
+        result = self.engine.nearest_cities('g150_151', 5, filter=even_column)
+
+        self.assertEqual(len(result.cities), 5)
+        self.assertTrue(all(even_column(c.city) for c in result.cities))
+        distances = [c.distance for c in result.cities]
+        self.assertEqual(distances, sorted(distances))
+        self.assertLess(len(tested), 100)
+        self.assertLess(result.stats.nodesSettled, self.SIDE * self.SIDE // 100)
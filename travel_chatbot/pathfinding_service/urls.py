@@ -12,9 +12,12 @@ urlpatterns = [
     path('api/longest_path', views.longest_path, name='longest_path'),
     path('api/fewest_stops', views.fewest_stops, name='fewest_stops'),
     path('api/reachable', views.reachable_cities, name='reachable'),
+    path('api/cities_within', views.cities_within, name='cities_within'),
+    path('api/isochrone', views.isochrone, name='isochrone'),
     path('api/multi_city_tour', views.multi_city_tour, name='multi_city_tour'),
     path('api/cheapest_network', views.cheapest_network, name='cheapest_network'),
     path('api/graph', views.get_graph, name='graph'),
     path('api/clear', views.clear_all, name='clear'),
     path('api/load_sample', views.load_sample, name='load_sample'),
+    path('metrics', views.metrics, name='metrics'),
 ]
@@ -1,4 +1,4 @@
-from django.http import JsonResponse
+from django.http import HttpResponse, JsonResponse
 from django.views.decorators.csrf import csrf_exempt
 from django.shortcuts import render
 import json
@@ -9,8 +9,10 @@ import os
 sys.path.insert(0, os.path.join(os.path.dirname(__file__), '../..'))
 import pathfinder
 
-# Global pathfinder instance
-pf = pathfinder.PathFinder()
+from .service import get_pathfinding_service
+
+# Process-wide engine, also behind the chatbot's pathfinding.TravelPlannerLib
+pf = pathfinder.shared_engine()
 
 def index(request):
     """Render the main pathfinder UI"""
@@ -128,6 +130,44 @@ def reachable_cities(request):
         })
     return JsonResponse({'cities': [], 'message': 'Invalid request'})
 
+def city_distances(cities):
+    return [{'city': c.city, 'distance': c.distance, 'stops': c.stops} for c in cities]
+
+@csrf_exempt
+def cities_within(request):
+    """Cities within a distance (or a number of stops) of a start city"""
+    if request.method == 'POST':
+        data = json.loads(request.body)
+        start = data.get('start')
+
+        if data.get('max_stops') is not None:
+            result = pf.cities_within_stops(start, int(data.get('max_stops')))
+        else:
+            result = pf.cities_within(start, int(data.get('max_distance')))
+        return JsonResponse({
+            'found': result.found,
+            'cities': city_distances(result.cities),
+            'message': result.message
+        })
+    return JsonResponse({'found': False, 'message': 'Invalid request'})
+
+@csrf_exempt
+def isochrone(request):
+    """Cities grouped into distance bands around a start city"""
+    if request.method == 'POST':
+        data = json.loads(request.body)
+        start = data.get('start')
+        radii = [int(r) for r in data.get('radii', [])]
+
+        result = pf.isochrone_bands(start, radii)
+        return JsonResponse({
+            'found': result.found,
+            'radii': result.radii,
+            'bands': [city_distances(band) for band in result.bands],
+            'message': result.message
+        })
+    return JsonResponse({'found': False, 'message': 'Invalid request'})
+
 @csrf_exempt
 def multi_city_tour(request):
     """Plan a multi-city tour"""
@@ -154,6 +194,11 @@ def cheapest_network(request):
         'message': result.message
     })
 
+def metrics(request):
+    """Engine metrics in Prometheus text format"""
+    return HttpResponse(pathfinder.metrics_text(),
+                        content_type='text/plain; version=0.0.4; charset=utf-8')
+
 def get_graph(request):
     """Get current graph data"""
     cities = pf.get_all_cities()
@@ -169,6 +214,7 @@ def clear_all(request):
     """Clear all graph data"""
     if request.method == 'POST':
         pf.clear_all()
+        get_pathfinding_service().invalidate()
         return JsonResponse({
             'success': True,
             'message': 'All data cleared'
@@ -181,6 +227,7 @@ def load_sample(request):
     if request.method == 'POST':
         # Clear existing data
         pf.clear_all()
+        get_pathfinding_service().invalidate()
         
         # Add comprehensive sample routes - USA cities with realistic distances
         sample_routes = [
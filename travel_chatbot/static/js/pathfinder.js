@@ -12,6 +12,7 @@ class GraphVisualizer {
         this.dragStart = { x: 0, y: 0 };
         this.highlightedPath = [];
         this.highlightedNodes = new Set();
+        this.bandColors = new Map(); // Isochrone band fill per city
         this.visitedNodes = new Set(); // Nodes that icon has reached
         this.animationFrame = null;
         this.movingIcon = null; // {type: 'bus'|'person', position: 0-1, path: [...]}
@@ -167,9 +168,20 @@ class GraphVisualizer {
         this.startAnimation();
     }
 
+    setBandColors(colors) {
+        this.bandColors = colors;
+        this.highlightedPath = [];
+        this.highlightedNodes.clear();
+        this.visitedNodes.clear();
+        this.movingIcon = null;
+        this.stopAnimation();
+        this.draw();
+    }
+
     clearHighlights() {
         this.highlightedPath = [];
         this.highlightedNodes.clear();
+        this.bandColors = new Map();
         this.visitedNodes.clear();
         this.movingIcon = null;
         this.stopAnimation();
@@ -341,8 +353,8 @@ class GraphVisualizer {
                     ctx.shadowBlur = 15 + pulse * 10;
                 }
             } else {
-                // Use node's assigned color
-                ctx.fillStyle = node.color || '#f1f5f9';
+                // Isochrone band, else the node's assigned color
+                ctx.fillStyle = this.bandColors.get(name) || node.color || '#f1f5f9';
                 ctx.shadowBlur = 0;
             }
 
@@ -352,7 +364,7 @@ class GraphVisualizer {
             ctx.stroke();
 
             ctx.shadowBlur = 0;
-            ctx.fillStyle = (isHighlighted || isVisited) ? '#ffffff' : '#1e293b';
+            ctx.fillStyle = (isHighlighted || isVisited || this.bandColors.has(name)) ? '#ffffff' : '#1e293b';
             ctx.font = 'bold 11px Inter';
             ctx.textAlign = 'center';
             ctx.textBaseline = 'middle';
@@ -538,6 +550,15 @@ class PathFinderAPI {
         return await response.json();
     }
 
+    async findIsochrone(start, radii) {
+        const response = await fetch(`${this.baseUrl}/isochrone`, {
+            method: 'POST',
+            headers: { 'Content-Type': 'application/json' },
+            body: JSON.stringify({ start, radii })
+        });
+        return await response.json();
+    }
+
     async planTour(cities) {
         const response = await fetch(`${this.baseUrl}/multi_city_tour`, {
             method: 'POST',
@@ -590,6 +611,7 @@ class PathFinderApp {
         document.getElementById('longestPathBtn').addEventListener('click', () => this.longestPath());
         document.getElementById('fewestStopsBtn').addEventListener('click', () => this.fewestStops());
         document.getElementById('reachableBtn').addEventListener('click', () => this.reachable());
+        document.getElementById('isochroneBtn').addEventListener('click', () => this.isochrone());
         document.getElementById('multiCityBtn').addEventListener('click', () => this.multiCityTour());
         document.getElementById('cheapestNetworkBtn').addEventListener('click', () => this.cheapestNetwork());
 
@@ -798,6 +820,38 @@ class PathFinderApp {
         });
     }
 
+    async isochrone() {
+        this.showInputModal('Isochrone Bands', ['Start City', 'Radii in km (comma-separated)'], async (values) => {
+            const radii = values[1].split(',').map(r => parseInt(r.trim())).filter(r => !isNaN(r));
+            try {
+                const result = await this.api.findIsochrone(values[0], radii);
+                if (result.found) {
+                    // Nearest band darkest
+                    const palette = ['#4338ca', '#6366f1', '#818cf8', '#a5b4fc', '#c7d2fe', '#e0e7ff'];
+                    const colors = new Map([[values[0], '#10b981']]);
+                    result.bands.forEach((band, i) => {
+                        const color = palette[Math.min(i, palette.length - 1)];
+                        band.forEach(c => colors.set(c.city, color));
+                    });
+                    this.visualizer.setBandColors(colors);
+
+                    const bandsHtml = result.bands.map((band, i) => `
+                        <p><strong>${i ? result.radii[i - 1] : 0}–${result.radii[i]} km</strong></p>
+                        <div class="city-list">
+                            ${band.map(c => `<span class="city-badge" style="border-left: 4px solid ${palette[Math.min(i, palette.length - 1)]}">${c.city} (${c.distance} km)</span>`).join('')}
+                        </div>
+                    `).join('');
+                    this.showResult('Isochrone Bands', bandsHtml);
+                } else {
+                    alert(result.message);
+                }
+            } catch (error) {
+                console.error('Error:', error);
+                alert('Failed to compute isochrone bands');
+            }
+        });
+    }
+
     async multiCityTour() {
         this.showInputModal('Multi-City Tour', ['Cities (comma-separated)'], async (values) => {
             const cities = values[0].split(',').map(c => c.trim()).filter(c => c);
@@ -148,3 +148,8 @@ REST_FRAMEWORK = {
 # Default primary key field type
 DEFAULT_AUTO_FIELD = 'django.db.models.BigAutoField'
 STATICFILES_DIRS = [BASE_DIR / 'static']
+
+# Binary graph snapshot the pathfinding service maps instead of reading
+# every route: it replays only the journal after the sequence the file was
+# saved at, and rewrites the file after a full load. Empty disables it.
+PATHFINDER_SNAPSHOT = os.getenv('PATHFINDER_SNAPSHOT', '')
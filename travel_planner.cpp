@@ -4,54 +4,125 @@
 #include <string>
 #include <climits>
 #include <algorithm>
+#include <memory>
+#include <new>
+#include <utility>
 
 using namespace std;
 
-// --- Custom Linked List based Stack for DFS & Path Reconstruction ---
+// --- Contiguous Stack for DFS & Path Reconstruction ---
+// Elements live in one growing array; pop() and clear() keep the capacity,
+// so a stack reused across traversals stops allocating once it is warm.
 template <typename T>
 class CustomStack {
 private:
-    struct Node { T data; Node* next; };
-    Node* topNode;
+    vector<T> items;
 public:
-    CustomStack() : topNode(nullptr) {}
-    void push(T val) { topNode = new Node{val, topNode}; }
-    void pop() {
-        if (topNode) {
-            Node* t = topNode;
-            topNode = topNode->next;
-            delete t;
-        }
+    void push(const T& val) { items.push_back(val); }
+    void push(T&& val) { items.push_back(move(val)); }
+    template <typename... Args>
+    T& emplace(Args&&... args) {
+        items.emplace_back(forward<Args>(args)...);
+        return items.back();
     }
-    T top() { return topNode->data; }
-    bool empty() { return topNode == nullptr; }
-    ~CustomStack() { while (!empty()) pop(); }
+    void pop() { if (!items.empty()) items.pop_back(); }
+    T& top() { return items.back(); }
+    const T& top() const { return items.back(); }
+    bool empty() const { return items.empty(); }
+    size_t size() const { return items.size(); }
+    void reserve(size_t n) { items.reserve(n); }
+    void clear() { items.clear(); }
 };
 
-// --- Custom Linked List based Queue for BFS ---
+// --- Chunked Ring-Buffer Queue for BFS ---
+// Elements are stored in fixed-size chunks. A chunk drained at the front is
+// parked in a spare list and reused at the back, so a queue that stays
+// below its high-water mark never allocates and never moves its elements.
 template <typename T>
 class CustomQueue {
 private:
-    struct Node { T data; Node* next; };
-    Node *frontNode, *rearNode;
+    static constexpr size_t CHUNK = sizeof(T) >= 1024 ? 4 : 4096 / sizeof(T);
+
+    vector<T*> chunks;   // live chunks, oldest first, starting at index head
+    vector<T*> spare;    // drained chunks kept for reuse
+    size_t head = 0;     // first live chunk
+    size_t frontPos = 0; // next element to dequeue within chunks[head]
+    size_t backPos = 0;  // next free slot within chunks.back()
+    size_t count = 0;
+
+    T* takeChunk() {
+        if (spare.empty()) return allocator<T>().allocate(CHUNK);
+        T* c = spare.back();
+        spare.pop_back();
+        return c;
+    }
+
+    T* slotForPush() {
+        if (chunks.size() == head || backPos == CHUNK) {
+            // Drop parked prefix slots once they outnumber the live chunks
+            if (head > 0 && head >= chunks.size() - head) {
+                chunks.erase(chunks.begin(), chunks.begin() + head);
+                head = 0;
+            }
+            chunks.push_back(takeChunk());
+            backPos = 0;
+        }
+        return chunks.back() + backPos;
+    }
+
 public:
-    CustomQueue() : frontNode(nullptr), rearNode(nullptr) {}
-    void enqueue(T val) {
-        Node* newNode = new Node{val, nullptr};
-        if (!rearNode) { frontNode = rearNode = newNode; return; }
-        rearNode->next = newNode; rearNode = newNode;
+    CustomQueue() {}
+    CustomQueue(const CustomQueue&) = delete;
+    CustomQueue& operator=(const CustomQueue&) = delete;
+
+    void enqueue(const T& val) { emplace(val); }
+    void enqueue(T&& val) { emplace(move(val)); }
+    template <typename... Args>
+    T& emplace(Args&&... args) {
+        T* slot = slotForPush();
+        new (slot) T(forward<Args>(args)...);
+        backPos++;
+        count++;
+        return *slot;
     }
+
     void dequeue() {
-        if (frontNode) {
-            Node* t = frontNode;
-            frontNode = frontNode->next;
-            if (!frontNode) rearNode = nullptr;
-            delete t;
+        if (count == 0) return;
+        chunks[head][frontPos].~T();
+        frontPos++;
+        count--;
+        if (count == 0) {
+            // Empty: every live chunk becomes spare, start over at slot 0
+            for (size_t i = head; i < chunks.size(); ++i) spare.push_back(chunks[i]);
+            chunks.clear();
+            head = frontPos = backPos = 0;
+        } else if (frontPos == CHUNK) {
+            spare.push_back(chunks[head++]);
+            frontPos = 0;
         }
     }
-    T front() { return frontNode->data; }
-    bool empty() { return frontNode == nullptr; }
-    ~CustomQueue() { while (!empty()) dequeue(); }
+
+    T& front() { return chunks[head][frontPos]; }
+    const T& front() const { return chunks[head][frontPos]; }
+    bool empty() const { return count == 0; }
+    size_t size() const { return count; }
+
+    // Pre-allocates room for n queued elements in total
+    void reserve(size_t n) {
+        size_t have = (chunks.size() - head + spare.size()) * CHUNK;
+        while (have < n) {
+            spare.push_back(allocator<T>().allocate(CHUNK));
+            have += CHUNK;
+        }
+    }
+
+    void clear() { while (count > 0) dequeue(); }
+
+    ~CustomQueue() {
+        clear();
+        for (size_t i = head; i < chunks.size(); ++i) allocator<T>().deallocate(chunks[i], CHUNK);
+        for (T* c : spare) allocator<T>().deallocate(c, CHUNK);
+    }
 };
 
 // --- Min-Priority Queue for Dijkstra/Prim ---
@@ -162,7 +233,7 @@ public:
         visited[start] = true;
 
         while (!q.empty()) {
-            string u = q.front(); q.dequeue();
+            string u = move(q.front()); q.dequeue();
             if (u == end) {
                 cout << "Route with fewest stops: "; printPath(parent, end);
                 cout << endl;
@@ -195,7 +266,7 @@ public:
         s.push(start);
         cout << "Reachable: ";
         while (!s.empty()) {
-            string u = s.top(); s.pop();
+            string u = move(s.top()); s.pop();
             if (!visited[u]) {
                 visited[u] = true;
                 cout << u << " ";
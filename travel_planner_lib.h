@@ -2,95 +2,27 @@
 #define TRAVEL_PLANNER_LIB_H
 
 #include <vector>
-#include <map>
 #include <string>
-#include <climits>
-#include <algorithm>
-#include <sstream>
-#include <memory>
+#include <tuple>
+#include <cstdint>
+#include "cpp_src/include/PathFinder.h"
 
 using namespace std;
 
-// --- Custom Linked List based Stack for DFS & Path Reconstruction ---
-template <typename T>
-class CustomStack {
-private:
-    struct Node { T data; Node* next; };
-    Node* topNode;
-public:
-    CustomStack() : topNode(nullptr) {}
-    void push(T val) { topNode = new Node{val, topNode}; }
-    void pop() {
-        if (topNode) {
-            Node* t = topNode;
-            topNode = topNode->next;
-            delete t;
-        }
-    }
-    T top() { return topNode->data; }
-    bool empty() { return topNode == nullptr; }
-    ~CustomStack() { while (!empty()) pop(); }
-};
-
-// --- Custom Linked List based Queue for BFS ---
-template <typename T>
-class CustomQueue {
-private:
-    struct Node { T data; Node* next; };
-    Node *frontNode, *rearNode;
-public:
-    CustomQueue() : frontNode(nullptr), rearNode(nullptr) {}
-    void enqueue(T val) {
-        Node* newNode = new Node{val, nullptr};
-        if (!rearNode) { frontNode = rearNode = newNode; return; }
-        rearNode->next = newNode; rearNode = newNode;
-    }
-    void dequeue() {
-        if (frontNode) {
-            Node* t = frontNode;
-            frontNode = frontNode->next;
-            if (!frontNode) rearNode = nullptr;
-            delete t;
-        }
-    }
-    T front() { return frontNode->data; }
-    bool empty() { return frontNode == nullptr; }
-    ~CustomQueue() { while (!empty()) dequeue(); }
-};
-
-// --- Min-Priority Queue for Dijkstra/Prim ---
-struct PQNode { int weight; string city; };
-class MinPQ {
-    vector<PQNode> heap;
-public:
-    void push(int w, string c) {
-        heap.push_back({w, c});
-        push_heap(heap.begin(), heap.end(), [](PQNode a, PQNode b) { return a.weight > b.weight; });
-    }
-    PQNode pop() {
-        pop_heap(heap.begin(), heap.end(), [](PQNode a, PQNode b) { return a.weight > b.weight; });
-        PQNode top = heap.back(); heap.pop_back();
-        return top;
-    }
-    bool empty() { return heap.empty(); }
-};
-
-struct Edge { string dest; int weight; };
-
 // Result structures for returning data instead of printing
 struct PathResult {
     bool success;
     string message;
     vector<string> path;
     int distance;
-    
+
     PathResult() : success(false), distance(0) {}
 };
 
 struct RouteOperationResult {
     bool success;
     string message;
-    
+
     RouteOperationResult() : success(false) {}
 };
 
@@ -99,241 +31,193 @@ struct MapStats {
     int totalRoutes;
 };
 
+// The chatbot's API on top of a PathFinder engine. Holds no graph of its
+// own: by default it works on PathFinder::shared(), so the chatbot and the
+// pathfinder module see the same network and the same caches.
 class TravelPlannerLib {
 private:
-    map<string, vector<Edge>> adjList;
-
-    // Helper to build path from parent map
-    vector<string> buildPath(map<string, string>& parent, const string& current) {
-        vector<string> path;
-        string node = current;
-        
-        while (parent.find(node) != parent.end()) {
-            path.push_back(node);
-            node = parent[node];
-        }
-        path.push_back(node);
-        
-        reverse(path.begin(), path.end());
-        return path;
-    }
+    PathFinder& engine;
 
 public:
-    TravelPlannerLib() {}
+    TravelPlannerLib() : engine(PathFinder::shared()) {}
+    explicit TravelPlannerLib(PathFinder& engine) : engine(engine) {}
 
-    // Add a route between two cities
+    // Add a route between two cities; adding an existing route replaces its distance
     RouteOperationResult addRoute(const string& u, const string& v, int w) {
         RouteOperationResult result;
-        
+
         if (w <= 0) {
             result.success = false;
             result.message = "Error: Distance must be positive.";
             return result;
         }
-        
-        adjList[u].push_back({v, w});
-        adjList[v].push_back({u, w});
-        
-        result.success = true;
-        result.message = "Successfully added: " + u + " <-> " + v + " (" + to_string(w) + "km)";
+
+        OperationResult added = engine.addCity(u, v, w);
+        result.success = added.success;
+        result.message = added.success
+            ? "Successfully added: " + u + " <-> " + v + " (" + to_string(w) + "km)"
+            : "Error: " + added.message;
         return result;
     }
 
     // Delete a route between two cities
     RouteOperationResult deleteRoute(const string& u, const string& v) {
         RouteOperationResult result;
-        
-        auto removeEdge = [&](const string& from, const string& to) -> bool {
-            if (adjList.count(from)) {
-                for (auto it = adjList[from].begin(); it != adjList[from].end(); ++it) {
-                    if (it->dest == to) {
-                        adjList[from].erase(it);
-                        return true;
-                    }
-                }
-            }
-            return false;
-        };
-        
-        if (removeEdge(u, v) && removeEdge(v, u)) {
-            result.success = true;
-            result.message = "Route between " + u + " and " + v + " deleted.";
-        } else {
-            result.success = false;
-            result.message = "Route not found.";
-        }
-        
+        result.success = engine.removeCity(u, v).success;
+        result.message = result.success ? "Route between " + u + " and " + v + " deleted."
+                                        : "Route not found.";
         return result;
     }
 
     // Find shortest path using Dijkstra's algorithm
     PathResult findShortestPath(const string& start, const string& end) {
         PathResult result;
-        
-        if (adjList.find(start) == adjList.end() || adjList.find(end) == adjList.end()) {
+
+        if (!engine.hasCity(start) || !engine.hasCity(end)) {
             result.success = false;
             result.message = "Error: One or both cities do not exist in the map.";
             return result;
         }
 
-        map<string, int> dist;
-        map<string, string> parent;
-        for (auto const& [city, _] : adjList) dist[city] = INT_MAX;
-
-        MinPQ pq;
-        dist[start] = 0;
-        pq.push(0, start);
-
-        while (!pq.empty()) {
-            PQNode top = pq.pop();
-            if (top.weight > dist[top.city]) continue;
-            if (top.city == end) break;
-
-            for (auto& edge : adjList[top.city]) {
-                if (dist[top.city] + edge.weight < dist[edge.dest]) {
-                    dist[edge.dest] = dist[top.city] + edge.weight;
-                    parent[edge.dest] = top.city;
-                    pq.push(dist[edge.dest], edge.dest);
-                }
-            }
-        }
-
-        if (dist[end] == INT_MAX) {
+        ShortestPathResult found = engine.findShortestPath(start, end);
+        if (!found.found) {
             result.success = false;
             result.message = "No route exists between " + start + " and " + end + ".";
         } else {
             result.success = true;
-            result.path = buildPath(parent, end);
-            result.distance = dist[end];
+            result.path = move(found.path);
+            result.distance = found.distance;
             result.message = "Path found successfully.";
         }
-        
+
         return result;
     }
 
     // Find path with fewest stops using BFS
     PathResult findFewestStops(const string& start, const string& end) {
         PathResult result;
-        
-        if (adjList.find(start) == adjList.end() || adjList.find(end) == adjList.end()) {
+
+        if (!engine.hasCity(start) || !engine.hasCity(end)) {
             result.success = false;
             result.message = "Error: Invalid cities.";
             return result;
         }
-        
-        map<string, bool> visited;
-        map<string, string> parent;
-        CustomQueue<string> q;
-
-        q.enqueue(start);
-        visited[start] = true;
-
-        while (!q.empty()) {
-            string u = q.front(); 
-            q.dequeue();
-            
-            if (u == end) {
-                result.success = true;
-                result.path = buildPath(parent, end);
-                result.message = "Route with fewest stops found.";
-                result.distance = result.path.size() - 1; // Number of hops
-                return result;
-            }
-            
-            for (auto& e : adjList[u]) {
-                if (!visited[e.dest]) {
-                    visited[e.dest] = true;
-                    parent[e.dest] = u;
-                    q.enqueue(e.dest);
-                }
-            }
+
+        FewestStopsResult found = engine.findFewestStops(start, end);
+        if (!found.found) {
+            result.success = false;
+            result.message = "Destination unreachable.";
+        } else {
+            result.success = true;
+            result.path = move(found.path);
+            result.distance = found.stops; // Number of hops
+            result.message = "Route with fewest stops found.";
         }
-        
-        result.success = false;
-        result.message = "Destination unreachable.";
         return result;
     }
 
     // Get all reachable cities from a starting point
     vector<string> getReachableCities(const string& start) {
-        vector<string> reachable;
-        
-        if (adjList.find(start) == adjList.end()) {
-            return reachable;
-        }
-        
-        map<string, bool> visited;
-        CustomStack<string> s;
-        s.push(start);
-        
-        while (!s.empty()) {
-            string u = s.top();
-            s.pop();
-            
-            if (!visited[u]) {
-                visited[u] = true;
-                if (u != start) {  // Don't include the starting city
-                    reachable.push_back(u);
-                }
-                for (auto& e : adjList[u]) {
-                    s.push(e.dest);
-                }
-            }
-        }
-        
-        return reachable;
+        return engine.findReachableCities(start);
     }
 
-    // Get map statistics
+    // Get map statistics; both counts are kept by the graph
     MapStats getMapStats() {
         MapStats stats;
-        stats.totalCities = adjList.size();
-        stats.totalRoutes = 0;
-        
-        for (auto const& [city, edges] : adjList) {
-            stats.totalRoutes += edges.size();
-        }
-        stats.totalRoutes /= 2; // Divide by 2 for undirected graph
-        
+        stats.totalCities = engine.cityCount();
+        stats.totalRoutes = (int)engine.routeCount();
         return stats;
     }
 
-    // Get all cities
+    // Get all cities, sorted by name
     vector<string> getAllCities() {
-        vector<string> cities;
-        for (auto const& [city, _] : adjList) {
-            cities.push_back(city);
-        }
-        return cities;
+        return engine.getAllCities();
     }
 
-    // Get all routes
+    // Get all routes, each once with the smaller name first
     vector<tuple<string, string, int>> getAllRoutes() {
-        vector<tuple<string, string, int>> routes;
-        map<pair<string, string>, bool> added;
-        
-        for (auto const& [city, edges] : adjList) {
-            for (auto const& edge : edges) {
-                string u = city;
-                string v = edge.dest;
-                
-                // Ensure we only add each undirected edge once
-                if (u > v) swap(u, v);
-                
-                pair<string, string> key = {u, v};
-                if (!added[key]) {
-                    routes.push_back({u, v, edge.weight});
-                    added[key] = true;
-                }
+        return engine.getAllRoutes();
+    }
+
+    // Add many (city1, city2, distance) routes at once
+    RouteOperationResult addRoutes(const vector<tuple<string, string, int>>& routes) {
+        RouteOperationResult result;
+        BulkLoadResult loaded = engine.addRoutes(routes);
+        result.success = loaded.success;
+        result.message = "Added " + to_string(loaded.rowsAccepted) + " routes (" +
+                         to_string(loaded.rowsRejected) + " rejected).";
+        return result;
+    }
+
+    // Add many routes at once; source/target index into names
+    RouteOperationResult addRoutesColumns(const vector<string>& names, const int32_t* source,
+                                          const int32_t* target, const int32_t* weight, size_t count) {
+        RouteOperationResult result;
+        BulkLoadResult loaded = engine.addRoutesColumns(names, source, target, weight, count);
+        result.success = loaded.success;
+        result.message = "Added " + to_string(loaded.rowsAccepted) + " routes (" +
+                         to_string(loaded.rowsRejected) + " rejected).";
+        return result;
+    }
+
+    // Columnar export indexed by city id, see PathFinder::exportNames
+    void exportNames(vector<uint8_t>& bytes, vector<int64_t>& offsets) {
+        engine.exportNames(bytes, offsets);
+    }
+
+    void exportRoutes(vector<int32_t>& source, vector<int32_t>& target, vector<int32_t>& weight) {
+        engine.exportRoutes(source, target, weight);
+    }
+
+    // Journalled changes as (sequence, "add" | "update" | "remove", city1,
+    // city2, distance) rows; see PathFinder::applyChanges
+    RouteOperationResult applyChanges(const vector<tuple<int64_t, string, string, string, int>>& rows) {
+        RouteOperationResult result;
+        vector<RouteChange> changes;
+        changes.reserve(rows.size());
+        for (const auto& [sequence, kindName, u, v, w] : rows) {
+            RouteChangeKind kind;
+            if (!RouteJournal::kindNamed(kindName, kind)) {
+                result.success = false;
+                result.message = "Error: Unknown change '" + kindName + "' at sequence " + to_string(sequence) + ".";
+                return result;
             }
+            changes.push_back({sequence, kind, u, v, w});
         }
-        
-        return routes;
+        JournalResult applied = engine.applyChanges(changes);
+        result.success = applied.success;
+        result.message = applied.message;
+        return result;
+    }
+
+    int64_t journalSequence() {
+        return engine.journalSequence();
+    }
+
+    void setJournalSequence(int64_t sequence) {
+        engine.setJournalSequence(sequence);
+    }
+
+    // Binary snapshot with the journal sequence; see PathFinder::save/load
+    RouteOperationResult saveSnapshot(const string& path) {
+        OperationResult saved = engine.save(path);
+        RouteOperationResult result;
+        result.success = saved.success;
+        result.message = saved.message;
+        return result;
+    }
+
+    RouteOperationResult loadSnapshot(const string& path) {
+        OperationResult loaded = engine.load(path);
+        RouteOperationResult result;
+        result.success = loaded.success;
+        result.message = loaded.message;
+        return result;
     }
 
     // Clear all data
     void clear() {
-        adjList.clear();
+        engine.clearAll();
     }
 };
 
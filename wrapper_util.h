@@ -0,0 +1,43 @@
+#ifndef WRAPPER_UTIL_H
+#define WRAPPER_UTIL_H
+
+#include <pybind11/pybind11.h>
+#include <pybind11/numpy.h>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace py = pybind11;
+using namespace std;
+
+// Helpers shared by the bindings compiled into the pathfinder module:
+// pathfinder_wrapper.cpp (PathFinder) and pathfinding_wrapper.cpp
+// (the chatbot's TravelPlannerLib)
+
+// Integer column accepted from NumPy; other integer dtypes are cast once
+using IntColumn = py::array_t<int32_t, py::array::c_style | py::array::forcecast>;
+
+// Engine calls run without the GIL so other Python threads keep going
+using NoGil = py::call_guard<py::gil_scoped_release>;
+
+inline void checkColumns(const IntColumn& source, const IntColumn& target, const IntColumn& weight) {
+    if (source.ndim() != 1 || target.ndim() != 1 || weight.ndim() != 1) {
+        throw py::value_error("source, target and weight must be 1-D arrays");
+    }
+    if (source.shape(0) != target.shape(0) || source.shape(0) != weight.shape(0)) {
+        throw py::value_error("source, target and weight must have the same length");
+    }
+}
+
+// Hands a vector's buffer to NumPy without copying it
+template <typename T>
+py::array_t<T> adopt(vector<T>&& values) {
+    auto* owned = new vector<T>(move(values));
+    py::capsule release(owned, [](void* p) { delete static_cast<vector<T>*>(p); });
+    return py::array_t<T>(owned->size(), owned->data(), release);
+}
+
+// Registers TravelPlannerLib and its result types (pathfinding_wrapper.cpp)
+void bindTravelPlanner(py::module_& m);
+
+#endif // WRAPPER_UTIL_H